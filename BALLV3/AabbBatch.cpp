@@ -0,0 +1,206 @@
+#include "AabbBatch.h"
+
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AABB_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//gcc and clang only emit AVX instructions in functions that ask for them, msvc emits them anywhere
+#if defined(AABB_X86) && !defined(_MSC_VER)
+#define AABB_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AABB_TARGET(isa)
+#endif
+
+void PackedAabbs::clear()
+{
+    minX.clear();
+    minY.clear();
+    maxX.clear();
+    maxY.clear();
+    count = 0;
+}
+
+void PackedAabbs::push(float x, float y, float w, float h)
+{
+    //overwrite padding left by a previous pad() instead of growing past it
+    if (minX.size() > count) {
+        minX.resize(count);
+        minY.resize(count);
+        maxX.resize(count);
+        maxY.resize(count);
+    }
+    minX.push_back(x);
+    minY.push_back(y);
+    maxX.push_back(x + w);
+    maxY.push_back(y + h);
+    count++;
+}
+
+void PackedAabbs::pad()
+{
+    //an inverted box: min above every max, so no strict overlap test can pass
+    const float infinity = std::numeric_limits<float>::infinity();
+    size_t padded = (count + 15) / 16 * 16;
+    minX.resize(padded, infinity);
+    minY.resize(padded, infinity);
+    maxX.resize(padded, -infinity);
+    maxY.resize(padded, -infinity);
+}
+
+namespace
+{
+    uint32_t overlapScalar(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first, int lanes)
+    {
+        uint32_t mask = 0;
+        for (int i = 0; i < lanes; ++i) {
+            size_t b = first + i;
+            if (qMinX < boxes.maxX[b] && boxes.minX[b] < qMaxX && qMinY < boxes.maxY[b] && boxes.minY[b] < qMaxY) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+    }
+
+#if defined(AABB_X86)
+    AABB_TARGET("sse2")
+    uint32_t overlapSse2(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+    {
+        __m128 hit = _mm_cmplt_ps(_mm_set1_ps(qMinX), _mm_loadu_ps(&boxes.maxX[first]));
+        hit = _mm_and_ps(hit, _mm_cmplt_ps(_mm_loadu_ps(&boxes.minX[first]), _mm_set1_ps(qMaxX)));
+        hit = _mm_and_ps(hit, _mm_cmplt_ps(_mm_set1_ps(qMinY), _mm_loadu_ps(&boxes.maxY[first])));
+        hit = _mm_and_ps(hit, _mm_cmplt_ps(_mm_loadu_ps(&boxes.minY[first]), _mm_set1_ps(qMaxY)));
+        return static_cast<uint32_t>(_mm_movemask_ps(hit));
+    }
+
+    AABB_TARGET("avx2")
+    uint32_t overlapAvx2(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+    {
+        __m256 hit = _mm256_cmp_ps(_mm256_set1_ps(qMinX), _mm256_loadu_ps(&boxes.maxX[first]), _CMP_LT_OQ);
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&boxes.minX[first]), _mm256_set1_ps(qMaxX), _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_set1_ps(qMinY), _mm256_loadu_ps(&boxes.maxY[first]), _CMP_LT_OQ));
+        hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_loadu_ps(&boxes.minY[first]), _mm256_set1_ps(qMaxY), _CMP_LT_OQ));
+        return static_cast<uint32_t>(_mm256_movemask_ps(hit));
+    }
+
+    AABB_TARGET("avx512f")
+    uint32_t overlapAvx512(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+    {
+        __mmask16 hit = _mm512_cmp_ps_mask(_mm512_set1_ps(qMinX), _mm512_loadu_ps(&boxes.maxX[first]), _CMP_LT_OQ);
+        hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(&boxes.minX[first]), _mm512_set1_ps(qMaxX), _CMP_LT_OQ);
+        hit = _mm512_mask_cmp_ps_mask(hit, _mm512_set1_ps(qMinY), _mm512_loadu_ps(&boxes.maxY[first]), _CMP_LT_OQ);
+        hit = _mm512_mask_cmp_ps_mask(hit, _mm512_loadu_ps(&boxes.minY[first]), _mm512_set1_ps(qMaxY), _CMP_LT_OQ);
+        return static_cast<uint32_t>(hit);
+    }
+#endif
+
+    AabbKernel::Path detectPath()
+    {
+#if defined(AABB_X86)
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        bool avx2 = false;
+        bool avx512 = false;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+            avx512 = (info[1] & (1 << 16)) != 0;
+        }
+        //the OS has to save the wider registers too, not just the CPU support them
+        if (avx512 && (xcr0 & 0xE6) == 0xE6) {
+            return AabbKernel::PATH_AVX512;
+        }
+        if (avx2 && (xcr0 & 0x6) == 0x6) {
+            return AabbKernel::PATH_AVX2;
+        }
+        if (sse2) {
+            return AabbKernel::PATH_SSE2;
+        }
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return AabbKernel::PATH_AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return AabbKernel::PATH_AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return AabbKernel::PATH_SSE2;
+        }
+#endif
+#endif
+        return AabbKernel::PATH_SCALAR;
+    }
+
+    const AabbKernel::Path supportedPath = detectPath();
+    AabbKernel::Path activePath = supportedPath;
+}
+
+AabbKernel::Path AabbKernel::getPath()
+{
+    return activePath;
+}
+
+void AabbKernel::setPath(Path path)
+{
+    activePath = path <= supportedPath ? path : supportedPath;
+}
+
+const char* AabbKernel::getPathName(Path path)
+{
+    switch (path) {
+    case PATH_SSE2: return "sse2";
+    case PATH_AVX2: return "avx2";
+    case PATH_AVX512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+uint32_t AabbKernel::overlap4(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+{
+#if defined(AABB_X86)
+    if (activePath >= PATH_SSE2) {
+        return overlapSse2(qMinX, qMinY, qMaxX, qMaxY, boxes, first);
+    }
+#endif
+    return overlapScalar(qMinX, qMinY, qMaxX, qMaxY, boxes, first, 4);
+}
+
+uint32_t AabbKernel::overlap8(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+{
+#if defined(AABB_X86)
+    if (activePath >= PATH_AVX2) {
+        return overlapAvx2(qMinX, qMinY, qMaxX, qMaxY, boxes, first);
+    }
+#endif
+    return overlap4(qMinX, qMinY, qMaxX, qMaxY, boxes, first)
+        | overlap4(qMinX, qMinY, qMaxX, qMaxY, boxes, first + 4) << 4;
+}
+
+uint32_t AabbKernel::overlap16(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+{
+#if defined(AABB_X86)
+    if (activePath >= PATH_AVX512) {
+        return overlapAvx512(qMinX, qMinY, qMaxX, qMaxY, boxes, first);
+    }
+#endif
+    return overlap8(qMinX, qMinY, qMaxX, qMaxY, boxes, first)
+        | overlap8(qMinX, qMinY, qMaxX, qMaxY, boxes, first + 8) << 8;
+}
+
+uint32_t AabbKernel::overlapMask(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first)
+{
+    //padding boxes never hit, so nothing past count needs masking off
+    return overlap16(qMinX, qMinY, qMaxX, qMaxY, boxes, first);
+}
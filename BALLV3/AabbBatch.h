@@ -0,0 +1,77 @@
+#pragma once
+#ifndef AabbBatch_h
+#define AabbBatch_h
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+* boxes stored as one array per edge so a SIMD lane reads the same edge of 4, 8 or 16 boxes at once
+* the arrays are always padded to a multiple of 16 with empty boxes that can never overlap anything
+*/
+struct PackedAabbs
+{
+    std::vector<float> minX, minY, maxX, maxY;
+    size_t count = 0;
+
+    void clear();
+    void push(float x, float y, float w, float h);
+
+    //pads the arrays so the widest kernel can read past count without going out of bounds
+    void pad();
+};
+
+class AabbKernel
+{
+public:
+    enum Path
+    {
+        PATH_SCALAR,
+        PATH_SSE2,
+        PATH_AVX2,
+        PATH_AVX512
+    };
+
+    /**
+     * Returns the kernel in use: the widest one the CPU and OS support, unless setPath narrowed it.
+     *
+     * @return The path used by overlap4, overlap8, overlap16 and overlapMask.
+     */
+    static Path getPath();
+
+    /**
+     * Forces a narrower kernel, mostly for benchmarking the paths against each other.
+     * Asking for a path the CPU does not support falls back to the detected one.
+     *
+     * @param path The kernel to use from now on.
+     */
+    static void setPath(Path path);
+
+    //short name of a path for logs and benchmark output
+    static const char* getPathName(Path path);
+
+    /**
+     * Tests one box against 4, 8 or 16 packed boxes.
+     *
+     * Overlap is strict on both axes, like SDL_HasIntersection: boxes that only share an edge do not hit.
+     *
+     * @param qMinX, qMinY, qMaxX, qMaxY The edges of the query box.
+     * @param boxes The packed boxes.
+     * @param first Index of the first box to test. first + 16 must not run past the padded arrays.
+     *
+     * @return A bitmask with bit i set when boxes[first + i] overlaps the query box.
+     */
+    static uint32_t overlap4(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first);
+    static uint32_t overlap8(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first);
+    static uint32_t overlap16(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first);
+
+    /**
+     * Tests one box against the next 16 packed boxes with the widest available kernel.
+     *
+     * @return A bitmask with bit i set when boxes[first + i] overlaps the query box.
+     *         Bits past boxes.count are always clear.
+     */
+    static uint32_t overlapMask(float qMinX, float qMinY, float qMaxX, float qMaxY, const PackedAabbs& boxes, size_t first);
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "AimBot.h"
+#include "Simulation.h"
+
+AimBot::AimBot(uint64_t seed, int aimJitter)
+    : rng(seed), aimJitter(aimJitter)
+{
+}
+
+void AimBot::aim(World& world)
+{
+    const float* entityY = world.entities.getPositionsY();
+    const uint8_t* entityFlags = world.entities.getFlags();
+
+    int target = -1;
+    for (size_t i = 0; i < world.entities.size(); ++i) {
+        if (entityFlags[i] & (ENTITY_PROJECTILE | ENTITY_WALL)) {
+            continue;
+        }
+        if (target < 0 || entityY[i] < entityY[target]) {
+            target = static_cast<int>(i);
+        }
+    }
+
+    int aimX, aimY;
+    if (target < 0) {
+        //nothing to shoot at, straight down
+        const Rect player = world.player.getRect();
+        aimX = player.x + player.w / 2;
+        aimY = world.windowHeight;
+    }
+    else {
+        const Rect hitbox = world.entities.getHitbox(target);
+        aimX = hitbox.x + hitbox.w / 2;
+        aimY = hitbox.y + hitbox.h / 2;
+    }
+
+    if (aimJitter > 0) {
+        aimX += rng.nextInt(2 * aimJitter + 1) - aimJitter;
+        aimY += rng.nextInt(2 * aimJitter + 1) - aimJitter;
+    }
+    world.player.aimAt(aimX, aimY);
+}
+
+bool AimBot::play(World& world)
+{
+    aim(world);
+
+    //shoot is ignored while a burst is in flight, so this is SPACE held down
+    return Simulation::fire(world);
+}
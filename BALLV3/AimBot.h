@@ -0,0 +1,43 @@
+#pragma once
+#ifndef AimBot_h
+#define AimBot_h
+#include <cstdint>
+
+#include "World.h"
+#include "Random.h"
+
+/*
+* scripted player for headless runs: aims at the planet closest to the game-over line and holds SPACE
+* it draws its aim error from its own generator, so it never disturbs the world's spawn stream
+*/
+class AimBot
+{
+public:
+    /**
+     * @param seed Seed of the bot's own generator.
+     * @param aimJitter The most the aim point strays from the planet's center, in pixels on each axis.
+     */
+    explicit AimBot(uint64_t seed, int aimJitter = 0);
+
+    /**
+     * Aims at the highest planet, or straight down when there is none, without firing.
+     *
+     * @param world The world to play.
+     */
+    void aim(World& world);
+
+    /**
+     * Aims and fires for one tick. Call it before Simulation::step.
+     *
+     * @param world The world to play.
+     *
+     * @return true if a burst was started, same as Simulation::fire.
+     */
+    bool play(World& world);
+
+private:
+    Random rng;
+    int aimJitter;
+};
+
+#endif
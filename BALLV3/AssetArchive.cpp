@@ -0,0 +1,236 @@
+#include "AssetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char magic[4] = { 'F', 'B', 'P', 'K' };
+    const uint32_t version = 1;
+
+    size_t alignUp(size_t offset)
+    {
+        return (offset + archiveAlignment - 1) / archiveAlignment * archiveAlignment;
+    }
+
+    //"assets/planet1.png" and "planet1.png" find the same entry
+    const char* baseName(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        return path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+    }
+}
+
+AssetArchive& AssetArchive::Instance()
+{
+    static AssetArchive instance;
+    return instance;
+}
+
+AssetArchive::~AssetArchive()
+{
+    close();
+}
+
+bool AssetArchive::open(const std::string& path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mappingHandle = GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0
+        ? CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "Could not map " << path << std::endl;
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        CloseHandle(fileHandle);
+        return false;
+    }
+    file = fileHandle;
+    mapping = mappingHandle;
+    base = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    void* view = fstat(descriptor, &info) == 0 && info.st_size > 0
+        ? mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+    //the mapping keeps the file alive on its own
+    ::close(descriptor);
+    if (view == MAP_FAILED) {
+        std::cerr << "Could not map " << path << std::endl;
+        return false;
+    }
+    base = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(info.st_size);
+#endif
+
+    //everything is checked once here, so lookups can trust the table
+    ArchiveHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, base, sizeof(header));
+        valid = memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version
+            && header.entryCount <= (size - sizeof(header)) / sizeof(ArchiveEntry);
+    }
+    if (valid) {
+        entries = reinterpret_cast<const ArchiveEntry*>(base + sizeof(header));
+        entryCount = header.entryCount;
+    }
+    for (uint32_t i = 0; valid && i < entryCount; ++i) {
+        const ArchiveEntry& entry = entries[i];
+        valid = entry.offset % archiveAlignment == 0 && entry.offset <= size && entry.size <= size - entry.offset
+            && memchr(entry.name, '\0', sizeof(entry.name)) != nullptr
+            && (i == 0 || strcmp(entries[i - 1].name, entry.name) < 0)
+            && (entry.kind != ARCHIVE_IMAGE || entry.size == static_cast<uint64_t>(entry.width) * entry.height * 4);
+    }
+    if (!valid) {
+        std::cerr << path << " is not an asset archive" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AssetArchive::close()
+{
+    if (!base) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(base);
+    CloseHandle(static_cast<HANDLE>(mapping));
+    CloseHandle(static_cast<HANDLE>(file));
+    file = nullptr;
+    mapping = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(base), size);
+#endif
+    base = nullptr;
+    size = 0;
+    entries = nullptr;
+    entryCount = 0;
+}
+
+const ArchiveEntry* AssetArchive::find(const std::string& name) const
+{
+    if (!base) {
+        return nullptr;
+    }
+    const char* key = baseName(name);
+    const ArchiveEntry* end = entries + entryCount;
+    const ArchiveEntry* entry = std::lower_bound(entries, end, key, [](const ArchiveEntry& candidate, const char* wanted) {
+        return strcmp(candidate.name, wanted) < 0;
+    });
+    return entry != end && strcmp(entry->name, key) == 0 ? entry : nullptr;
+}
+
+SDL_Surface* AssetArchive::loadImage(const std::string& name) const
+{
+    const ArchiveEntry* entry = find(name);
+    if (!entry || entry->kind != ARCHIVE_IMAGE) {
+        return nullptr;
+    }
+    //SDL never writes to a surface's pixels unless it is drawn on, and archive images are only read
+    return SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(getData(*entry)), static_cast<int>(entry->width),
+        static_cast<int>(entry->height), 32, static_cast<int>(entry->width * 4), SDL_PIXELFORMAT_RGBA32);
+}
+
+Mix_Chunk* AssetArchive::loadSound(const std::string& name) const
+{
+    const ArchiveEntry* entry = find(name);
+    if (!entry || entry->kind != ARCHIVE_SOUND) {
+        return nullptr;
+    }
+
+    //samples baked for another output format would play at the wrong pitch or as noise
+    int frequency = 0, channels = 0;
+    Uint16 format = 0;
+    if (!Mix_QuerySpec(&frequency, &format, &channels) || static_cast<uint32_t>(frequency) != entry->frequency
+        || format != entry->format || static_cast<uint32_t>(channels) != entry->channels) {
+        return nullptr;
+    }
+    //the chunk doesn't own the samples, Mix_FreeChunk leaves the mapping alone
+    return Mix_QuickLoad_RAW(const_cast<uint8_t*>(getData(*entry)), static_cast<Uint32>(entry->size));
+}
+
+SDL_RWops* AssetArchive::openFile(const std::string& name) const
+{
+    const ArchiveEntry* entry = find(name);
+    if (!entry || entry->kind != ARCHIVE_RAW) {
+        return nullptr;
+    }
+    return SDL_RWFromConstMem(getData(*entry), static_cast<int>(entry->size));
+}
+
+bool AssetArchive::save(const std::string& path, std::vector<ArchiveEntry> tableEntries, const std::vector<std::vector<uint8_t>>& data)
+{
+    if (tableEntries.size() != data.size()) {
+        return false;
+    }
+    std::vector<size_t> order(tableEntries.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&tableEntries](size_t a, size_t b) {
+        return strcmp(tableEntries[a].name, tableEntries[b].name) < 0;
+    });
+
+    std::vector<ArchiveEntry> sorted;
+    size_t offset = alignUp(sizeof(ArchiveHeader) + order.size() * sizeof(ArchiveEntry));
+    for (size_t i : order) {
+        if (!sorted.empty() && strcmp(sorted.back().name, tableEntries[i].name) == 0) {
+            std::cerr << "Two assets named " << tableEntries[i].name << std::endl;
+            return false;
+        }
+        ArchiveEntry entry = tableEntries[i];
+        entry.offset = offset;
+        entry.size = data[i].size();
+        sorted.push_back(entry);
+        offset = alignUp(offset + data[i].size());
+    }
+
+    ArchiveHeader header = {};
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.entryCount = static_cast<uint32_t>(sorted.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sorted.data()), static_cast<std::streamsize>(sorted.size() * sizeof(ArchiveEntry)));
+    size_t written = sizeof(header) + sorted.size() * sizeof(ArchiveEntry);
+    const char zeros[archiveAlignment] = {};
+    for (size_t i = 0; i < order.size(); ++i) {
+        out.write(zeros, static_cast<std::streamsize>(sorted[i].offset - written));
+        out.write(reinterpret_cast<const char*>(data[order[i]].data()), static_cast<std::streamsize>(data[order[i]].size()));
+        written = sorted[i].offset + data[order[i]].size();
+    }
+    if (!out) {
+        std::cerr << "Could not write asset archive " << path << std::endl;
+        return false;
+    }
+    return true;
+}
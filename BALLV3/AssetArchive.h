@@ -0,0 +1,144 @@
+#pragma once
+#ifndef AssetArchive_h
+#define AssetArchive_h
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+* every asset of the game baked into one file by ballpack (BALLV3Pack), memory-mapped when the game starts
+*
+* images are stored as raw RGBA32 pixels at the size the game packs them at, sound effects as PCM in
+* the format Audio opens the mixer with, fonts and music as their file bytes
+* loading one is then a surface, a Mix_Chunk or an SDL_RWops pointing into the mapping, with no decode and no copy
+*
+* layout, little-endian: an ArchiveHeader, the table of contents as ArchiveEntry records sorted by name,
+* then the data of every entry starting on an archiveAlignment boundary
+* callers ask for assets by the file name they used to load, and fall back to the file when the archive
+* doesn't have it, so a game without assets.pak loads exactly as before
+*/
+
+enum ArchiveKind
+{
+    //file bytes as they are: fonts, streamed music
+    ARCHIVE_RAW = 0,
+    //RGBA32 pixels, width * 4 bytes a row
+    ARCHIVE_IMAGE,
+    //interleaved PCM in the entry's frequency, format and channels
+    ARCHIVE_SOUND
+};
+
+//every entry's data starts on this many bytes, a cache line, so pixels and samples are aligned where they lie
+const size_t archiveAlignment = 64;
+
+struct ArchiveHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct ArchiveEntry
+{
+    //the file name the asset was packed from, without its folder, nul terminated
+    char name[48];
+    uint32_t kind;
+    //images only
+    uint32_t width;
+    uint32_t height;
+    //sounds only, an SDL_AudioFormat
+    uint32_t frequency;
+    uint32_t format;
+    uint32_t channels;
+    //from the start of the archive
+    uint64_t offset;
+    uint64_t size;
+};
+
+class AssetArchive
+{
+public:
+    //the archive every loader checks first
+    static AssetArchive& Instance();
+
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    /**
+     * Maps an archive into memory and checks its table of contents, replacing the archive opened before.
+     *
+     * @param path The archive written by save.
+     *
+     * @return true if the archive is mapped and whole, false otherwise.
+     */
+    bool open(const std::string& path);
+
+    //unmaps the archive, after everything loaded from it has been freed
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+
+    //the entry packed from a file of that name, nullptr if there is none. Folders in the name are ignored
+    const ArchiveEntry* find(const std::string& name) const;
+
+    //where an entry's data is mapped
+    const uint8_t* getData(const ArchiveEntry& entry) const { return base + entry.offset; }
+
+    /**
+     * An image straight from the mapping, without copying its pixels. The pixels are read-only.
+     *
+     * @param name The image's file name.
+     *
+     * @return A surface for SDL_FreeSurface, or nullptr if the archive doesn't have the image.
+     */
+    SDL_Surface* loadImage(const std::string& name) const;
+
+    /**
+     * A sound effect straight from the mapping, without copying its samples.
+     *
+     * @param name The sound's file name.
+     *
+     * @return A chunk for Mix_FreeChunk, or nullptr if the archive doesn't have the sound or the
+     *         mixer was opened in another format than it was baked in.
+     */
+    Mix_Chunk* loadSound(const std::string& name) const;
+
+    /**
+     * A file's bytes, for the loaders that read a stream: TTF_OpenFontRW, Mix_LoadMUS_RW.
+     *
+     * @param name The file name.
+     *
+     * @return An SDL_RWops over the mapping, nullptr if the archive doesn't have the file.
+     */
+    SDL_RWops* openFile(const std::string& name) const;
+
+    /**
+     * Writes an archive. Entries are sorted by name and their offsets and sizes filled in.
+     *
+     * @param path The file to create or overwrite.
+     * @param entries The table of contents, kind and format fields set.
+     * @param data Every entry's bytes, in the same order as entries.
+     *
+     * @return true if the whole file was written, false otherwise.
+     */
+    static bool save(const std::string& path, std::vector<ArchiveEntry> entries, const std::vector<std::vector<uint8_t>>& data);
+
+private:
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    const ArchiveEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+#if defined(_WIN32)
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+#endif
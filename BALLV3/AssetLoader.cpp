@@ -0,0 +1,136 @@
+#include "AssetLoader.h"
+
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#include "AssetArchive.h"
+#include "Profiler.h"
+#include "SpriteAtlas.h"
+
+AssetLoader::AssetLoader(int threads)
+    : threadCount(threads)
+{
+    if (threadCount <= 0) {
+        //the main thread keeps uploading and drawing the splash
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+}
+
+AssetLoader::~AssetLoader()
+{
+    cancel();
+}
+
+int AssetLoader::addImage(const std::string& path, int packedWidth, int packedHeight)
+{
+    const int handle = static_cast<int>(assets.size());
+    assets.emplace_back(new LoadedAsset(handle, ASSET_IMAGE, path, packedWidth, packedHeight));
+    return handle;
+}
+
+int AssetLoader::addSound(const std::string& path)
+{
+    const int handle = static_cast<int>(assets.size());
+    assets.emplace_back(new LoadedAsset(handle, ASSET_SOUND, path, 0, 0));
+    return handle;
+}
+
+void AssetLoader::start()
+{
+    startTime = std::chrono::steady_clock::now();
+    const int count = std::min(threadCount, static_cast<int>(assets.size()));
+    for (int worker = 0; worker < count; ++worker) {
+        workers.emplace_back(&AssetLoader::work, this, worker);
+    }
+}
+
+void AssetLoader::cancel()
+{
+    //a worker's next claim lands past the end, the ones it already claimed finish decoding
+    nextAsset.store(assets.size());
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    for (std::unique_ptr<LoadedAsset>& asset : assets) {
+        SDL_FreeSurface(asset->image);
+        asset->image = nullptr;
+        if (asset->sound) {
+            Mix_FreeChunk(asset->sound);
+            asset->sound = nullptr;
+        }
+    }
+}
+
+void AssetLoader::work(int worker)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "asset loader %d", worker);
+    Profiler::setThreadName(name);
+
+    for (size_t index = nextAsset++; index < assets.size(); index = nextAsset++) {
+        decode(*assets[index]);
+    }
+}
+
+void AssetLoader::decode(LoadedAsset& asset)
+{
+    PROFILE_ZONE("decode asset");
+    const std::chrono::steady_clock::time_point decodeStart = std::chrono::steady_clock::now();
+
+    if (asset.kind == ASSET_IMAGE) {
+        //the asset archive's baked pixels skip the decode, only a resize may be left
+        SDL_Surface* loaded = AssetArchive::Instance().loadImage(asset.path);
+        if (!loaded) {
+            loaded = IMG_Load(asset.path.c_str());
+        }
+        if (!loaded) {
+            std::cout << "MERDE TEXTURE : " << asset.path << " " << IMG_GetError() << std::endl;
+        }
+        else {
+            asset.image = SpriteAtlas::prepare(loaded, asset.packedWidth, asset.packedHeight);
+            if (!asset.image) {
+                std::cout << "Could not convert " << asset.path << ": " << SDL_GetError() << std::endl;
+            }
+        }
+    }
+    else {
+        asset.sound = AssetArchive::Instance().loadSound(asset.path);
+        if (!asset.sound) {
+            asset.sound = Mix_LoadWAV(asset.path.c_str());
+        }
+        if (!asset.sound) {
+            std::cerr << "Failed to load " << asset.path << ": " << Mix_GetError() << std::endl;
+        }
+    }
+
+    asset.decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart).count();
+    decodedCount++;
+    asset.decoded.store(true, std::memory_order_release);
+}
+
+float AssetLoader::getProgress() const
+{
+    if (assets.empty()) {
+        return 1.0f;
+    }
+    return static_cast<float>(decodedCount.load() + uploadedCount) / (2.0f * assets.size());
+}
+
+void AssetLoader::report(std::ostream& out) const
+{
+    double decodeTotal = 0.0, uploadTotal = 0.0;
+    char line[160];
+    for (const std::unique_ptr<LoadedAsset>& asset : assets) {
+        snprintf(line, sizeof(line), "  %-24s decode %7.2f ms  upload %7.2f ms\n", asset->path.c_str(), asset->decodeMs, asset->uploadMs);
+        out << line;
+        decodeTotal += asset->decodeMs;
+        uploadTotal += asset->uploadMs;
+    }
+    snprintf(line, sizeof(line), "%zu assets loaded in %.2f ms on %zu threads: %.2f ms decoding, %.2f ms uploading\n",
+        assets.size(), finishedMs, workers.size(), decodeTotal, uploadTotal);
+    out << line;
+}
@@ -0,0 +1,185 @@
+#pragma once
+#ifndef AssetLoader_h
+#define AssetLoader_h
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* decodes the game's images and sounds on a pool of worker threads while the main thread shows a splash screen
+*
+* workers only touch files and surfaces: IMG_Load, the atlas' pixel conversion and Mix_LoadWAV,
+* or the asset archive's baked pixels and samples when it has them
+* every upload, a texture or anything else that needs the renderer, happens on the main thread in
+* uploadDecoded(), as soon as each asset is decoded, so decoding and uploading overlap
+* decode and upload times are kept per asset for the cold-start report
+*
+*     AssetLoader loader;
+*     const int background = loader.addImage("background2.png");
+*     loader.start();
+*     while (!loader.isDone()) {
+*         loader.uploadDecoded([&](LoadedAsset& asset) { ... take asset.image or asset.sound ... });
+*         ...draw the splash...
+*     }
+*     loader.cancel();                  //joins the workers, before SDL or the asset archive is shut down
+*/
+
+enum AssetKind
+{
+    ASSET_IMAGE,
+    ASSET_SOUND
+};
+
+struct LoadedAsset
+{
+    //what add returned
+    int handle;
+    AssetKind kind;
+    std::string path;
+    //the atlas size of an image, 0 keeps its own
+    int packedWidth;
+    int packedHeight;
+
+    //set by the decode, the upload callback takes it over, nullptr if the file couldn't be read
+    SDL_Surface* image = nullptr;
+    Mix_Chunk* sound = nullptr;
+
+    double decodeMs = 0.0;
+    double uploadMs = 0.0;
+    //published by the worker once image or sound is set
+    std::atomic<bool> decoded{ false };
+    bool uploaded = false;
+
+    LoadedAsset(int handle, AssetKind kind, const std::string& path, int packedWidth, int packedHeight)
+        : handle(handle), kind(kind), path(path), packedWidth(packedWidth), packedHeight(packedHeight)
+    {
+    }
+};
+
+class AssetLoader
+{
+public:
+    /**
+     * @param threads Worker threads to decode on, 0 for one per core but one, at least one.
+     */
+    explicit AssetLoader(int threads = 0);
+
+    //cancels whatever is left, see cancel()
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * Queues an image, loaded and converted to the sprite atlas' format by SpriteAtlas::prepare.
+     * Only before start().
+     *
+     * @param path The image file.
+     * @param packedWidth The width to scale it to, 0 keeps its own.
+     * @param packedHeight The height to scale it to, 0 keeps its own.
+     *
+     * @return The handle of the asset, handles count up from 0.
+     */
+    int addImage(const std::string& path, int packedWidth = 0, int packedHeight = 0);
+
+    /**
+     * Queues a sound effect, decoded by Mix_LoadWAV to the format the mixer was opened with.
+     * Only before start(), and after Mix_OpenAudio.
+     *
+     * @param path The sound file.
+     *
+     * @return The handle of the asset.
+     */
+    int addSound(const std::string& path);
+
+    //starts the workers on everything queued, the clock of the report starts too
+    void start();
+
+    /**
+     * Stops the workers from claiming another asset, waits for the decodes already running,
+     * then frees whatever was decoded and never uploaded.
+     * Nothing is left running on the workers afterwards, so SDL, SDL_mixer and the asset archive may be shut down.
+     * Does nothing more once everything was uploaded, or when called again.
+     */
+    void cancel();
+
+    /**
+     * Hands every asset decoded since the last call to an upload callback, on the calling thread, and times it.
+     *
+     * @param upload Called with (LoadedAsset& asset) for each decoded asset, in the order they were added.
+     *               It takes over asset.image or asset.sound, either may be nullptr if decoding failed.
+     * @param budgetMs Stops handing assets out once this much time was spent, 0 for no limit.
+     *
+     * @return How many assets were uploaded by this call.
+     */
+    template <typename Upload>
+    size_t uploadDecoded(Upload&& upload, double budgetMs = 0.0)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point callStart = Clock::now();
+        size_t count = 0;
+        for (std::unique_ptr<LoadedAsset>& asset : assets) {
+            if (asset->uploaded || !asset->decoded.load(std::memory_order_acquire)) {
+                continue;
+            }
+            const Clock::time_point uploadStart = Clock::now();
+            upload(*asset);
+            const Clock::time_point uploadEnd = Clock::now();
+            asset->image = nullptr;
+            asset->sound = nullptr;
+            asset->uploadMs = std::chrono::duration<double, std::milli>(uploadEnd - uploadStart).count();
+            asset->uploaded = true;
+            uploadedCount++;
+            count++;
+            if (budgetMs > 0.0 && std::chrono::duration<double, std::milli>(uploadEnd - callStart).count() >= budgetMs) {
+                break;
+            }
+        }
+        if (uploadedCount == assets.size() && finishedMs == 0.0) {
+            finishedMs = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+        }
+        return count;
+    }
+
+    //true once every asset is decoded and uploaded
+    bool isDone() const { return uploadedCount == assets.size(); }
+
+    //share of the work done, decodes and uploads counted alike, from 0 to 1
+    float getProgress() const;
+
+    size_t getAssetCount() const { return assets.size(); }
+    size_t getUploadedCount() const { return uploadedCount; }
+
+    /**
+     * Writes one line per asset with its decode and upload time, then the total time from start() to the last upload.
+     *
+     * @param out The stream to write to, std::cout for instance.
+     */
+    void report(std::ostream& out) const;
+
+private:
+    //a worker's loop: claims the next asset until there are none left
+    void work(int worker);
+    void decode(LoadedAsset& asset);
+
+    int threadCount;
+    std::vector<std::thread> workers;
+    //every asset is claimed by one worker through this index
+    std::atomic<size_t> nextAsset{ 0 };
+    std::atomic<size_t> decodedCount{ 0 };
+    size_t uploadedCount = 0;
+    //added before start(), the vector is never resized while workers run
+    std::vector<std::unique_ptr<LoadedAsset>> assets;
+
+    std::chrono::steady_clock::time_point startTime;
+    double finishedMs = 0.0;
+};
+
+#endif
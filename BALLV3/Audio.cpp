@@ -1,7 +1,8 @@
 #include "Audio.h"
+#include "AssetArchive.h"
 #include <iostream>
 
-Audio::Audio() : hitSound(nullptr), deathSound(nullptr), levelUpSound(nullptr) {}
+Audio::Audio() : hitSound(nullptr), deathSound(nullptr), levelUpSound(nullptr), gameOver(nullptr), bg(nullptr), voices(mixChannels) {}
 
 Audio::~Audio() {
     cleanup();
@@ -13,20 +14,38 @@ bool Audio::initialize() {
         return false;
     }
 
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+    if (Mix_OpenAudio(frequency, format, channels, chunkSize) < 0) {
         std::cerr << "Mixer initialization failed: " << Mix_GetError() << std::endl;
         return false;
     }
+    voices.open();
 
     return true;
 }
 
+bool Audio::startSoftMixer(int bufferFrames) {
+    int openedFrequency = 0, openedChannels = 0;
+    Uint16 openedFormat = 0;
+    if (!Mix_QuerySpec(&openedFrequency, &openedFormat, &openedChannels) || openedFormat != AUDIO_S16SYS || openedChannels != 2) {
+        std::cerr << "The soft mixer only mixes 16-bit stereo, sound effects stay on SDL_mixer" << std::endl;
+        return false;
+    }
+    std::unique_ptr<SoftMixer> mixer(new SoftMixer());
+    if (!mixer->open(openedFrequency, bufferFrames)) {
+        return false;
+    }
+    softMixer = std::move(mixer);
+    voices.setMixer(softMixer.get());
+    return true;
+}
+
 bool Audio::loadMp3(const std::string& hitFilePath, const std::string& deathFilePath, const std::string& levelUpFilePath, const std::string& bgFilePath, const std::string& gOFilePath) {
-    hitSound = Mix_LoadWAV(hitFilePath.c_str());
-    deathSound = Mix_LoadWAV(deathFilePath.c_str());
-    levelUpSound = Mix_LoadWAV(levelUpFilePath.c_str());
-    bg = Mix_LoadMUS(bgFilePath.c_str());
-    gameOver = Mix_LoadWAV(gOFilePath.c_str());
+    hitSound = loadChunk(hitFilePath);
+    deathSound = loadChunk(deathFilePath);
+    levelUpSound = loadChunk(levelUpFilePath);
+    loadMusic(bgFilePath);
+    gameOver = loadChunk(gOFilePath);
+    setVoices();
 
     if (!hitSound) {
         std::cerr << "Failed to load hit sound: " << Mix_GetError() << std::endl;
@@ -44,6 +63,46 @@ bool Audio::loadMp3(const std::string& hitFilePath, const std::string& deathFile
     return true;
 }
 
+bool Audio::setSounds(Mix_Chunk* hit, Mix_Chunk* death, Mix_Chunk* levelUp, Mix_Chunk* gameOverSound) {
+    Mix_Chunk** slots[] = { &hitSound, &deathSound, &levelUpSound, &gameOver };
+    Mix_Chunk* chunks[] = { hit, death, levelUp, gameOverSound };
+    voices.haltAll();
+    for (int i = 0; i < 4; ++i) {
+        if (*slots[i]) {
+            Mix_FreeChunk(*slots[i]);
+        }
+        *slots[i] = chunks[i];
+    }
+    setVoices();
+    return hitSound && deathSound && levelUpSound;
+}
+
+bool Audio::loadMusic(const std::string& bgFilePath) {
+    if (bg) {
+        Mix_FreeMusic(bg);
+    }
+    SDL_RWops* packed = AssetArchive::Instance().openFile(bgFilePath);
+    bg = packed ? Mix_LoadMUS_RW(packed, 1) : Mix_LoadMUS(bgFilePath.c_str());
+    if (!bg) {
+        std::cerr << "Failed to load music: " << Mix_GetError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Mix_Chunk* Audio::loadChunk(const std::string& filePath) {
+    Mix_Chunk* chunk = AssetArchive::Instance().loadSound(filePath);
+    return chunk ? chunk : Mix_LoadWAV(filePath.c_str());
+}
+
+void Audio::setVoices() {
+    //priority, voices at once, volume of a single event
+    voices.setSound(SOUND_HIT, hitSound, { 1, 4, 80 });
+    voices.setSound(SOUND_DEATH, deathSound, { 0, 2, 80 });
+    voices.setSound(SOUND_LEVEL_UP, levelUpSound, { 3, 1, MIX_MAX_VOLUME });
+    voices.setSound(SOUND_GAME_OVER, gameOver, { 2, 3, 96 });
+}
+
 void Audio::playBg()
 {
     if (bg) {
@@ -58,7 +117,7 @@ void Audio::playGameOver()
 {
     if (gameOver)
     {
-        Mix_PlayChannel(-1, gameOver, 0);
+        voices.trigger(SOUND_GAME_OVER);
     }
     else {
         std::cout << "Game over sound no good" << std::endl;
@@ -67,7 +126,7 @@ void Audio::playGameOver()
 
 void Audio::playHitSound() {
     if (hitSound) {
-        Mix_PlayChannel(-1, hitSound, 0);
+        voices.trigger(SOUND_HIT);
     }
     else {
         std::cout << "Hit sound no good" << std::endl;
@@ -76,7 +135,7 @@ void Audio::playHitSound() {
 
 void Audio::playDeathSound() {
     if (deathSound) {
-        Mix_PlayChannel(-1, deathSound, 0);
+        voices.trigger(SOUND_DEATH);
     }
     else {
         std::cout << "Death sound no good" << std::endl;
@@ -85,14 +144,31 @@ void Audio::playDeathSound() {
 
 void Audio::playLevelUpSound() {
     if (levelUpSound) {
-        Mix_PlayChannel(-1, levelUpSound, 0);
+        voices.trigger(SOUND_LEVEL_UP);
     }
     else {
         std::cout << "Level-up sound no good" << std::endl;
     }
 }
 
+void Audio::update() {
+    voices.update();
+}
+
+int Audio::getVoicesInUse() const {
+    if (softMixer) {
+        return softMixer->getVoicesPlaying();
+    }
+    return Mix_Playing(-1);
+}
+
 void Audio::cleanup() {
+    //nothing may still be playing a chunk when it is freed
+    voices.haltAll();
+    if (softMixer) {
+        voices.setMixer(nullptr);
+        softMixer.reset();
+    }
     if (hitSound) {
         Mix_FreeChunk(hitSound);
         hitSound = nullptr;
@@ -105,6 +181,14 @@ void Audio::cleanup() {
         Mix_FreeChunk(levelUpSound);
         levelUpSound = nullptr;
     }
+    if (gameOver) {
+        Mix_FreeChunk(gameOver);
+        gameOver = nullptr;
+    }
+    if (bg) {
+        Mix_FreeMusic(bg);
+        bg = nullptr;
+    }
 
     Mix_CloseAudio();
     SDL_Quit();
@@ -3,10 +3,22 @@
 
 #include <SDL.h>
 #include <SDL_mixer.h>
+#include <memory>
 #include <string>
 
-class Audio {
+#include "SoundSink.h"
+#include "VoiceManager.h"
+
+class Audio : public SoundSink {
 public:
+    //what the mixer is opened with, and what ballpack bakes sound effects in
+    static const int frequency = 44100;
+    static const Uint16 format = MIX_DEFAULT_FORMAT;
+    static const int channels = 2;
+    static const int chunkSize = 2048;
+    //mixer channels for sound effects, the VoiceManager shares them out
+    static const int mixChannels = 16;
+
     /**
      * @brief Constructor for the Audio class.
      *
@@ -36,11 +48,26 @@ public:
      */
     bool initialize();
 
+    /**
+     * @brief Moves the sound effects to a SoftMixer on a device of its own, with short buffers.
+     *
+     * SDL_mixer keeps the background music. Call it after initialize() and before the sounds are set.
+     * Needs the mixer opened as 16-bit stereo, the only format the SoftMixer mixes.
+     *
+     * @param bufferFrames Samples per channel in a buffer of the mixer's device, 256 is under 6 ms at 44.1 kHz.
+     *
+     * @return true if the effects now play on the SoftMixer; false if they stay on SDL_mixer.
+     */
+    bool startSoftMixer(int bufferFrames = 256);
+
+    //the mixer the effects play on, nullptr while SDL_mixer plays them
+    const SoftMixer* getSoftMixer() const { return softMixer.get(); }
+
     /**
      * @brief Loads and initializes the sound effects for the game.
      *
      * This function loads the sound effects for the "hit", "death", and "level-up" events.
-     * The sound effects are loaded from the specified WAV files.
+     * The sound effects are loaded from the specified WAV files, or from the asset archive when it has them.
      *
      * @param hitFilePath The file path to the WAV file containing the "hit" sound effect.
      * @param deathFilePath The file path to the WAV file containing the "death" sound effect.
@@ -50,39 +77,64 @@ public:
      * @return true if the sound effects are successfully loaded and initialized; false otherwise.
      */
     bool loadMp3(const std::string& hitFilePath, const std::string& deathFilePath, const std::string& levelUpFilePath, const std::string& bgFilePath, const std::string& gOFilePath);
+
+    /**
+     * @brief Hands over sound effects decoded elsewhere, by the AssetLoader for instance.
+     *
+     * The Audio class takes the chunks over and frees them in cleanup(), along with any effect loaded before.
+     * A nullptr leaves that effect silent.
+     *
+     * @param hit The "hit" sound effect.
+     * @param death The "death" sound effect.
+     * @param levelUp The "level-up" sound effect.
+     * @param gameOverSound The game over sound.
+     *
+     * @return true if the "hit", "death" and "level-up" effects are all there; false otherwise.
+     */
+    bool setSounds(Mix_Chunk* hit, Mix_Chunk* death, Mix_Chunk* levelUp, Mix_Chunk* gameOverSound);
+
+    /**
+     * @brief Opens the background music. It is streamed from the file, or the asset archive, while it plays,
+     * so there is nothing to decode ahead.
+     *
+     * @param bgFilePath The file path to the background music.
+     *
+     * @return true if the music could be opened; false otherwise.
+     */
+    bool loadMusic(const std::string& bgFilePath);
     
     /**
      * @brief Plays the hit sound effect.
      *
-     * This function plays the sound effect associated with the "hit" event.
+     * This function plays the sound effect associated with the "hit" event, at the next update().
      * The sound effect is loaded from the file specified during the initialization
      * of the Audio class.
      *
      * @return void
      */
-    void playHitSound();
+    void playHitSound() override;
 
     /**
      * @brief Plays the death sound effect.
      *
-     * This function plays the sound effect associated with the "death" event.
+     * This function plays the sound effect associated with the "death" event, at the next update().
      * The sound effect is loaded from the file specified during the initialization
      * of the Audio class.
      *
      * @return void
      */    
-    void playDeathSound();
+    void playDeathSound() override;
 
     /**
      * @brief Plays the level-up sound effect.
      *
-     * This function plays the sound effect associated with the "level-up" event.
+     * This function plays the sound effect associated with the "level-up" event, at the next update().
      * The sound effect is loaded from the file specified during the initialization
      * of the Audio class.
      *
      * @return void
      */
-    void playLevelUpSound();
+    void playLevelUpSound() override;
 
     /**
      * @brief Plays the background music.
@@ -98,13 +150,33 @@ public:
     /**
      * @brief Plays the gameOver sound.
      *
-     * This function plays the sound effect associated with the "gameOver" event.
+     * This function plays the sound effect associated with the "gameOver" event, at the next update().
      * The sound effect is loaded from the file specified during the initialization
      * of the Audio class.
      *
      * @return void
      */    
-    void playGameOver();
+    void playGameOver() override;
+
+    /**
+     * @brief Plays the sound effects triggered since the last call.
+     *
+     * The play functions only count events, so a burst of hits in one frame becomes one louder voice
+     * instead of a channel each. Call it once a frame, after the simulation ticks.
+     *
+     * @return void
+     */
+    void update();
+
+    /**
+     * @brief Counts the mixer channels playing right now.
+     *
+     * The background music plays outside the channels and is not counted.
+     * With a SoftMixer, its voices playing are counted instead.
+     *
+     * @return The number of sound effects playing.
+     */
+    int getVoicesInUse() const;
 
     /**
      * @brief Cleans up and frees the SDL_mixer resources used by the Audio class.
@@ -117,11 +189,26 @@ public:
     void cleanup();
 
 private:
+    //a sound effect from the asset archive, decoded from its file when the archive doesn't have it
+    static Mix_Chunk* loadChunk(const std::string& filePath);
+    //hands the loaded chunks to the voice manager with their priorities and voice caps
+    void setVoices();
+
+    enum SoundEffect
+    {
+        SOUND_HIT,
+        SOUND_DEATH,
+        SOUND_LEVEL_UP,
+        SOUND_GAME_OVER
+    };
+
     Mix_Chunk* hitSound;  
     Mix_Chunk* deathSound; 
     Mix_Chunk* levelUpSound;
     Mix_Chunk* gameOver;
     Mix_Music* bg;
+    VoiceManager voices;
+    std::unique_ptr<SoftMixer> softMixer;
 };
 
 #endif // AUDIO_H
@@ -0,0 +1,162 @@
+#include "BroadPhase.h"
+
+#include <algorithm>
+#include <cmath>
+
+UniformGrid::UniformGrid(float originX, float originY, float width, float height, float cellSize)
+    : originX(originX), originY(originY), cellSize(cellSize)
+{
+    columns = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+    cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+}
+
+int UniformGrid::cellX(float worldX) const
+{
+    int cell = static_cast<int>(std::floor((worldX - originX) / cellSize));
+    return std::min(std::max(cell, 0), columns - 1);
+}
+
+int UniformGrid::cellY(float worldY) const
+{
+    int cell = static_cast<int>(std::floor((worldY - originY) / cellSize));
+    return std::min(std::max(cell, 0), rows - 1);
+}
+
+void UniformGrid::reserve(size_t bodies)
+{
+    //a body no bigger than a cell overlaps at most four of them
+    cellItems.reserve(4 * bodies);
+    visitStamp.reserve(bodies);
+    candidates.reserve(bodies);
+    candidateBounds.minX.reserve(bodies + 16);
+    candidateBounds.minY.reserve(bodies + 16);
+    candidateBounds.maxX.reserve(bodies + 16);
+    candidateBounds.maxY.reserve(bodies + 16);
+}
+
+bool UniformGrid::needsRebuild(const EntityRegistry& entities) const
+{
+    return builtFrom != &entities || builtVersion != entities.getLayoutVersion();
+}
+
+void UniformGrid::rebuild(const EntityRegistry& entities)
+{
+    const size_t count = entities.size();
+    const float* positionX = entities.getPositionsX();
+    const float* positionY = entities.getPositionsY();
+    const float* hitWidth = entities.getHitWidths();
+    const float* hitHeight = entities.getHitHeights();
+    const uint8_t* flags = entities.getFlags();
+
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+
+    //first pass: count how many bodies land in each cell
+    for (size_t i = 0; i < count; ++i) {
+        if (flags[i] & ENTITY_PROJECTILE) {
+            continue;
+        }
+        int x0 = cellX(positionX[i]), x1 = cellX(positionX[i] + hitWidth[i]);
+        int y0 = cellY(positionY[i]), y1 = cellY(positionY[i] + hitHeight[i]);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                cellStart[cy * columns + cx + 1]++;
+            }
+        }
+    }
+
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+    cellItems.resize(cellStart.back());
+
+    //second pass: scatter, bodies are visited in index order so every cell stays sorted
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        if (flags[i] & ENTITY_PROJECTILE) {
+            continue;
+        }
+        int x0 = cellX(positionX[i]), x1 = cellX(positionX[i] + hitWidth[i]);
+        int y0 = cellY(positionY[i]), y1 = cellY(positionY[i] + hitHeight[i]);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                cellItems[cellCursor[cy * columns + cx]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    if (visitStamp.size() < count) {
+        visitStamp.resize(count, queryStamp);
+    }
+
+    builtFrom = &entities;
+    builtVersion = entities.getLayoutVersion();
+}
+
+const std::vector<uint32_t>& UniformGrid::query(const Rect& area)
+{
+    candidates.clear();
+
+    //stamps tell us which bodies this query already reported, without clearing an array
+    if (++queryStamp == 0) {
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        queryStamp = 1;
+    }
+
+    //bodies killed earlier in the tick stay binned until the flush but are never reported
+    const uint8_t* entityFlags = builtFrom->getFlags();
+
+    //one pixel of slack covers the float-to-int truncation of the hitboxes
+    int x0 = cellX(static_cast<float>(area.x - 1)), x1 = cellX(static_cast<float>(area.x + area.w + 1));
+    int y0 = cellY(static_cast<float>(area.y - 1)), y1 = cellY(static_cast<float>(area.y + area.h + 1));
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const int cell = cy * columns + cx;
+            for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                uint32_t index = cellItems[k];
+                if (visitStamp[index] != queryStamp) {
+                    visitStamp[index] = queryStamp;
+                    if (!(entityFlags[index] & ENTITY_DEAD)) {
+                        candidates.push_back(index);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    //gather the hitboxes the same way EntityRegistry::getHitbox truncates them
+    const float* positionX = builtFrom->getPositionsX();
+    const float* positionY = builtFrom->getPositionsY();
+    const float* hitWidth = builtFrom->getHitWidths();
+    const float* hitHeight = builtFrom->getHitHeights();
+    candidateBounds.clear();
+    for (uint32_t index : candidates) {
+        candidateBounds.push(static_cast<float>(static_cast<int>(positionX[index])),
+            static_cast<float>(static_cast<int>(positionY[index])), hitWidth[index], hitHeight[index]);
+    }
+    candidateBounds.pad();
+
+    return candidates;
+}
+
+const PackedAabbs& UniformGrid::getCandidateBounds() const
+{
+    return candidateBounds;
+}
+
+void UniformGrid::resetPairsTested()
+{
+    pairsTested = 0;
+}
+
+void UniformGrid::addPairsTested(size_t count)
+{
+    pairsTested += count;
+}
+
+size_t UniformGrid::getPairsTested() const
+{
+    return pairsTested;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#ifndef BroadPhase_h
+#define BroadPhase_h
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EntityRegistry.h"
+#include "AabbBatch.h"
+
+/*
+* Uniform grid over the playfield used to cut projectile-vs-entity tests down
+* to the bodies sharing a cell with the projectile.
+* Bodies outside the grid are clamped into the border cells, so nothing is ever missed,
+* it just lands in a busier cell.
+*/
+class UniformGrid
+{
+public:
+    /**
+     * Creates an empty grid covering the given area.
+     *
+     * @param originX The world x-coordinate of the left edge of the grid.
+     * @param originY The world y-coordinate of the top edge of the grid.
+     * @param width The width of the covered area in pixels.
+     * @param height The height of the covered area in pixels.
+     * @param cellSize The side of a square cell in pixels.
+     */
+    UniformGrid(float originX, float originY, float width, float height, float cellSize);
+
+    /**
+     * Checks whether the grid was built from a different registry or an older layout of it.
+     *
+     * @param entities The registry the grid is about to be queried for.
+     *
+     * @return true if rebuild must be called before querying, false otherwise.
+     */
+    bool needsRebuild(const EntityRegistry& entities) const;
+
+    /**
+     * Bins every non-projectile body of the registry into the cells its hitbox overlaps.
+     *
+     * Uses a counting sort into one flat array, so rebuilding reuses the same storage every time.
+     *
+     * @param entities The registry to bin.
+     */
+    void rebuild(const EntityRegistry& entities);
+
+    /**
+     * Sizes the grid storage for up to the given number of bodies, so rebuilds and queries
+     * below that count never allocate.
+     *
+     * @param bodies The number of bodies the grid is expected to hold.
+     */
+    void reserve(size_t bodies);
+
+    /**
+     * Collects the dense indices of the bodies whose cells overlap the given area.
+     *
+     * Each index is reported once, in ascending order, so callers see candidates in the same
+     * order as a brute-force loop over the registry would. Bodies flagged ENTITY_DEAD are left out.
+     *
+     * @param area The area to query, usually the swept hitbox of a projectile.
+     *
+     * @return The candidate indices. The vector is owned by the grid and reused by the next query.
+     */
+    const std::vector<uint32_t>& query(const Rect& area);
+
+    /**
+     * Hitboxes of the candidates returned by the last query, packed for AabbKernel.
+     *
+     * Box k is the hitbox of candidate k, so a hit bit maps straight back to an entity index.
+     *
+     * @return The packed, padded candidate hitboxes.
+     */
+    const PackedAabbs& getCandidateBounds() const;
+
+    //counter of candidate pairs handed to the narrowphase, reset at the start of every checkCollisions call (once per tick)
+    void resetPairsTested();
+    void addPairsTested(size_t count);
+    size_t getPairsTested() const;
+
+private:
+    int cellX(float worldX) const;
+    int cellY(float worldY) const;
+
+    float originX, originY;
+    float cellSize;
+    int columns, rows;
+
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellItems;
+    std::vector<uint32_t> cellCursor;
+    std::vector<uint32_t> visitStamp;
+    std::vector<uint32_t> candidates;
+    PackedAabbs candidateBounds;
+    uint32_t queryStamp = 0;
+
+    const EntityRegistry* builtFrom = nullptr;
+    uint32_t builtVersion = 0;
+
+    size_t pairsTested = 0;
+};
+
+#endif
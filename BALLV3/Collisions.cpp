@@ -1,56 +1,207 @@
 #include "Collisions.h"
 #include "Entities.h"
+#include "Player.h"
+#include "Profiler.h"
 
-bool Collisions::contact(const SDL_Rect& rectA, const SDL_Rect& rectB)
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+bool Collisions::contact(const Rect& rectA, const Rect& rectB)
 {
 
-    return SDL_HasIntersection(&rectA, &rectB);
+    return rectA.x < rectB.x + rectB.w && rectB.x < rectA.x + rectA.w
+        && rectA.y < rectB.y + rectB.h && rectB.y < rectA.y + rectA.h
+        && rectA.w > 0 && rectA.h > 0 && rectB.w > 0 && rectB.h > 0;
 }
 
 
-bool Collisions::checkCollisions(std::vector<Entity>& entities, std::vector<Entity>& projectiles, Player& player, Audio& audio, Audio& audio3)
+bool Collisions::checkCollisions(EntityRegistry& entities, EntityRegistry& projectiles, UniformGrid& broadphase, GameEventBuffer& events)
 {
+    PROFILE_ZONE("checkCollisions");
+    const int maxSweeps = 4;
     bool collisionDetected = false;
+    broadphase.resetPairsTested();
 
-    for (auto& projectile : projectiles) {
-        projectile.updateDelay(0.0005);
-        const SDL_Rect projectileHitbox = projectile.getHitbox();
-
-        for (auto entityIt = entities.begin(); entityIt != entities.end();) {
+    float* positionX = projectiles.getPositionsX();
+    float* positionY = projectiles.getPositionsY();
+    const float* velocityX = projectiles.getVelocitiesX();
+    const float* velocityY = projectiles.getVelocitiesY();
 
-            const SDL_Rect entityHitbox = entityIt->getHitbox();
+    //kills are deferred to the end of the tick, so the layout the grid was built from holds for the whole loop
+    if (broadphase.needsRebuild(entities)) {
+        broadphase.rebuild(entities);
+    }
 
-            if (!entityIt->getisProjectile() && contact(projectileHitbox, entityHitbox)) {
-                projectile.setCollisionDelay(0.0002); 
+    for (size_t p = 0; p < projectiles.size(); ++p) {
+        if (projectiles.hasFlag(p, ENTITY_DEAD)) {
+            continue;
+        }
+        projectiles.updateDelay(p, 0.0005);
 
-                float angle = calculateImpactAngle(projectile.getVelocityX(), projectile.getVelocityY());
+        //push out of anything the wave shift moved on top of the projectile
+        const Rect projectileHitbox = projectiles.getHitbox(p);
+        const std::vector<uint32_t>& overlapping = broadphase.query(projectileHitbox);
+        broadphase.addPairsTested(overlapping.size());
 
-                bounceProjectile(projectile, entityHitbox);
+        const size_t first = firstOverlap(projectileHitbox, broadphase.getCandidateBounds());
+        if (first != SIZE_MAX) {
+            const uint32_t i = overlapping[first];
+            bounceProjectile(projectiles, p, entities.getHitbox(i));
+            hitEntity(entities, i, projectiles, p, events);
+            collisionDetected = true;
+        }
 
-                projectile.setHasCollided(true);
-                audio.playHitSound();
+        //sweep the motion of the tick, stopping at the earliest contact and carrying on from there
+        float remaining = 1.0f;
+        for (int sweep = 0; sweep < maxSweeps && remaining > 0.0f; ++sweep) {
+            const float moveX = velocityX[p] * remaining;
+            const float moveY = velocityY[p] * remaining;
+            const Rect start = projectiles.getHitbox(p);
 
-                if (!entityIt-> getIsWall() && entityIt->takeDamage()) {
-                    entityIt = entities.erase(entityIt);
-                    player.incrementScore(audio3);
-                    audio.playGameOver();
+            const Rect swept = sweptHitbox(start, moveX, moveY);
+            const std::vector<uint32_t>& candidates = broadphase.query(swept);
+            const PackedAabbs& bounds = broadphase.getCandidateBounds();
+            broadphase.addPairsTested(candidates.size());
 
+            //only entities overlapping the swept box can be hit, the kernel rules the rest out 16 at a time
+            SweepHit earliest;
+            size_t target = SIZE_MAX;
+            for (size_t base = 0; base < bounds.count; base += 16) {
+                uint32_t mask = AabbKernel::overlapMask(static_cast<float>(swept.x), static_cast<float>(swept.y),
+                    static_cast<float>(swept.x + swept.w), static_cast<float>(swept.y + swept.h), bounds, base);
+                for (size_t k = base; mask != 0; ++k, mask >>= 1) {
+                    SweepHit hit;
+                    if ((mask & 1) && sweepAABB(start, moveX, moveY, entities.getHitbox(candidates[k]), hit)
+                        && hit.time < earliest.time) {
+                        earliest = hit;
+                        target = candidates[k];
+                    }
                 }
-                else {
-                    ++entityIt;
-                }
+            }
 
-                collisionDetected = true;
+            if (target == SIZE_MAX) {
+                positionX[p] += moveX;
+                positionY[p] += moveY;
                 break;
             }
-            else {
-                ++entityIt;
-            }
+
+            bounceProjectile(projectiles, p, entities.getHitbox(target), earliest, moveX, moveY);
+            hitEntity(entities, target, projectiles, p, events);
+            remaining *= 1.0f - earliest.time;
+            collisionDetected = true;
         }
     }
     return collisionDetected;
 }
 
+size_t Collisions::firstOverlap(const Rect& rect, const PackedAabbs& boxes)
+{
+    for (size_t base = 0; base < boxes.count; base += 16) {
+        uint32_t mask = AabbKernel::overlapMask(static_cast<float>(rect.x), static_cast<float>(rect.y),
+            static_cast<float>(rect.x + rect.w), static_cast<float>(rect.y + rect.h), boxes, base);
+        for (size_t k = base; mask != 0; ++k, mask >>= 1) {
+            if (mask & 1) {
+                return k;
+            }
+        }
+    }
+    return SIZE_MAX;
+}
+
+void Collisions::hitEntity(EntityRegistry& entities, size_t entity, EntityRegistry& projectiles, size_t projectile,
+    GameEventBuffer& events)
+{
+    projectiles.setCollisionDelay(projectile, 0.0002);
+    projectiles.setFlag(projectile, ENTITY_COLLIDED, true);
+    events.push(EVENT_HIT, static_cast<uint32_t>(entity));
+
+    if (!entities.hasFlag(entity, ENTITY_WALL) && entities.takeDamage(entity)) {
+        entities.kill(entity);
+        events.push(EVENT_KILL, static_cast<uint32_t>(entity));
+    }
+}
+
+Rect Collisions::sweptHitbox(const Rect& hitbox, float moveX, float moveY)
+{
+    Rect swept = hitbox;
+    const int extentX = static_cast<int>(std::ceil(std::fabs(moveX)));
+    const int extentY = static_cast<int>(std::ceil(std::fabs(moveY)));
+
+    if (moveX < 0) {
+        swept.x -= extentX;
+    }
+    if (moveY < 0) {
+        swept.y -= extentY;
+    }
+    swept.w += extentX;
+    swept.h += extentY;
+    return swept;
+}
+
+/*
+*slab test per axis: entry = when the faces start overlapping, exit = when they stop
+*the boxes overlap between the latest entry and the earliest exit
+*the axis that entered last is the face that was hit
+*/
+bool Collisions::sweepAABB(const Rect& moving, float moveX, float moveY, const Rect& target, SweepHit& hit)
+{
+    const float infinity = std::numeric_limits<float>::infinity();
+    float entryX, exitX, entryY, exitY;
+
+    if (moveX > 0.0f) {
+        entryX = (target.x - (moving.x + moving.w)) / moveX;
+        exitX = ((target.x + target.w) - moving.x) / moveX;
+    }
+    else if (moveX < 0.0f) {
+        entryX = ((target.x + target.w) - moving.x) / moveX;
+        exitX = (target.x - (moving.x + moving.w)) / moveX;
+    }
+    else if (moving.x < target.x + target.w && target.x < moving.x + moving.w) {
+        entryX = -infinity;
+        exitX = infinity;
+    }
+    else {
+        return false;
+    }
+
+    if (moveY > 0.0f) {
+        entryY = (target.y - (moving.y + moving.h)) / moveY;
+        exitY = ((target.y + target.h) - moving.y) / moveY;
+    }
+    else if (moveY < 0.0f) {
+        entryY = ((target.y + target.h) - moving.y) / moveY;
+        exitY = (target.y - (moving.y + moving.h)) / moveY;
+    }
+    else if (moving.y < target.y + target.h && target.y < moving.y + moving.h) {
+        entryY = -infinity;
+        exitY = infinity;
+    }
+    else {
+        return false;
+    }
+
+    const float entry = std::max(entryX, entryY);
+    const float exit = std::min(exitX, exitY);
+
+    //already overlapping (entry < 0) is left to the overlap pass, touching (entry == exit) is not a hit
+    if (entry >= exit || entry < 0.0f || entry >= 1.0f) {
+        return false;
+    }
+
+    hit.time = entry;
+    if (entryX > entryY) {
+        hit.normalX = moveX > 0.0f ? -1 : 1;
+        hit.normalY = 0;
+    }
+    else {
+        hit.normalX = 0;
+        hit.normalY = moveY > 0.0f ? -1 : 1;
+    }
+    return true;
+}
+
 
 
 /*
@@ -60,8 +211,12 @@ bool Collisions::checkCollisions(std::vector<Entity>& entities, std::vector<Enti
 *Apply bounce
 */
 
-void Collisions::bounceProjectile(Entity& projectile, const SDL_Rect& entityHitbox) {
-    SDL_Rect projectileHitbox = projectile.getHitbox();
+void Collisions::bounceProjectile(EntityRegistry& projectiles, size_t index, const Rect& entityHitbox) {
+    Rect projectileHitbox = projectiles.getHitbox(index);
+    float* positionX = projectiles.getPositionsX();
+    float* positionY = projectiles.getPositionsY();
+    float* velocityX = projectiles.getVelocitiesX();
+    float* velocityY = projectiles.getVelocitiesY();
     float bounceMultiplier = 0.8f; 
 
     int overlapX = 0;
@@ -82,39 +237,69 @@ void Collisions::bounceProjectile(Entity& projectile, const SDL_Rect& entityHitb
         // Horizontal 
         if (projectileHitbox.x + projectileHitbox.w / 2 < entityHitbox.x + entityHitbox.w / 2) {
             // left
-            projectile.setPositionX(entityHitbox.x - projectileHitbox.w);
+            positionX[index] = static_cast<float>(entityHitbox.x - projectileHitbox.w);
         }
         else {
             // right
-            projectile.setPositionX(entityHitbox.x + entityHitbox.w);
+            positionX[index] = static_cast<float>(entityHitbox.x + entityHitbox.w);
         }
-        projectile.setVelocityX(-projectile.getVelocityX() * bounceMultiplier);
+        velocityX[index] = -velocityX[index] * bounceMultiplier;
     }
     else {
         // Vertical 
         if (projectileHitbox.y + projectileHitbox.h / 2 < entityHitbox.y + entityHitbox.h / 2) {
             // above
-            projectile.setPositionY(entityHitbox.y - projectileHitbox.h);
+            positionY[index] = static_cast<float>(entityHitbox.y - projectileHitbox.h);
         }
         else {
             // below
-            projectile.setPositionY(entityHitbox.y + entityHitbox.h);
+            positionY[index] = static_cast<float>(entityHitbox.y + entityHitbox.h);
         }
-        projectile.setVelocityY(-projectile.getVelocityY() * bounceMultiplier);
+        velocityY[index] = -velocityY[index] * bounceMultiplier;
+    }
+}
+
+void Collisions::bounceProjectile(EntityRegistry& projectiles, size_t index, const Rect& entityHitbox,
+    const SweepHit& hit, float moveX, float moveY)
+{
+    const Rect projectileHitbox = projectiles.getHitbox(index);
+    float* positionX = projectiles.getPositionsX();
+    float* positionY = projectiles.getPositionsY();
+    float* velocityX = projectiles.getVelocitiesX();
+    float* velocityY = projectiles.getVelocitiesY();
+    float bounceMultiplier = 0.8f;
+
+    if (hit.normalX != 0) {
+        // Horizontal: flush against the left or right face, travel along y up to the contact
+        positionX[index] = static_cast<float>(hit.normalX < 0 ? entityHitbox.x - projectileHitbox.w : entityHitbox.x + entityHitbox.w);
+        positionY[index] += moveY * hit.time;
+        velocityX[index] = -velocityX[index] * bounceMultiplier;
+    }
+    else {
+        // Vertical: flush against the top or bottom face, travel along x up to the contact
+        positionY[index] = static_cast<float>(hit.normalY < 0 ? entityHitbox.y - projectileHitbox.h : entityHitbox.y + entityHitbox.h);
+        positionX[index] += moveX * hit.time;
+        velocityY[index] = -velocityY[index] * bounceMultiplier;
     }
 }
 
-void Collisions::applyGravity(std::vector<Entity>& projectiles, float gravityStrength)
+void Collisions::applyGravity(EntityRegistry& projectiles, float gravityStrength)
 {
-    for (auto& projectile : projectiles) {
-        if (projectile.getisProjectile() && projectile.getHasCollided()) {
-            float newVelocityY = projectile.getVelocityY() + gravityStrength;
-            projectile.setVelocityY(newVelocityY);
+    PROFILE_ZONE("applyGravity");
+    const uint8_t* flags = projectiles.getFlags();
+    float* velocityY = projectiles.getVelocitiesY();
+    const uint8_t bouncedProjectile = ENTITY_PROJECTILE | ENTITY_COLLIDED;
+
+    for (size_t i = 0; i < projectiles.size(); ++i) {
+        if ((flags[i] & bouncedProjectile) == bouncedProjectile) {
+            velocityY[i] += gravityStrength;
         }
     }
 }
 
 float Collisions::calculateImpactAngle(float velocityX, float velocityY)
 {
-    return atan2(velocityY, velocityX) * 180.0f / M_PI;
+    //M_PI came in through SDL's headers before, it isn't standard C++
+    const double pi = 3.14159265358979323846;
+    return static_cast<float>(atan2(velocityY, velocityX) * 180.0 / pi);
 }
\ No newline at end of file
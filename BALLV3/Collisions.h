@@ -2,12 +2,11 @@
 #ifndef Collisions_h
 #define Collisions_h
 #include "Entities.h"
-#include "Player.h"
-#include "Entities.h"
-#include "Audio.h"
-
-#include <SDL.h>
-#include <SDL_image.h>
+#include "EntityRegistry.h"
+#include "BroadPhase.h"
+#include "AabbBatch.h"
+#include "SimTypes.h"
+#include "GameEvents.h"
 
 #include <cmath>
 #include <iostream>
@@ -17,40 +16,80 @@ class Entity;
 class Player;
 class PowerUp;
 
+/*
+* result of a swept test: how far along the motion the first contact happens,
+* and which face of the target was hit
+*/
+struct SweepHit {
+    float time = 1.0f;
+    int normalX = 0;
+    int normalY = 0;
+};
+
 class Collisions{
 public:
     /**
-     * Checks for a collision between two SDL_Rect objects.
+     * Checks for a collision between two Rect objects.
      *
      * This function determines if two rectangular areas overlap by comparing their positions
      * and dimensions. If the rectangles intersect, the function returns true; otherwise, it
-     * returns false.
+     * returns false. Rectangles that only share an edge do not collide, same as SDL_HasIntersection.
      *
-     * @param rectA A const reference to the first SDL_Rect object to check for collision.
-     * @param rectB A const reference to the second SDL_Rect object to check for collision.
+     * @param rectA A const reference to the first Rect object to check for collision.
+     * @param rectB A const reference to the second Rect object to check for collision.
      *
      * @return A boolean value indicating whether the two rectangles intersect (true) or not (false).
      */
-    static bool contact(const SDL_Rect& rectA, const SDL_Rect& rectB);
+    static bool contact(const Rect& rectA, const Rect& rectB);
 
     /**
-     * Checks for collisions between entities, projectiles, and the player.
+     * Finds the time of impact of a moving box against a static one.
+     *
+     * The moving box travels by (moveX, moveY) over the tick. Boxes that only touch, or that
+     * are moving apart, do not count as a hit.
      *
-     * This function iterates through the given collections of entities and projectiles,
-     * and checks for collisions between them and the player. If a collision is detected,
-     * the appropriate actions are taken, such as updating the player's health, triggering
-     * audio effects, or applying bounce effects to projectiles.
+     * @param moving The hitbox of the moving body at the start of the motion.
+     * @param moveX The x-displacement of the moving body over the motion.
+     * @param moveY The y-displacement of the moving body over the motion.
+     * @param target The hitbox of the static body.
+     * @param hit Filled with the time of impact in [0, 1) and the normal of the face that was hit.
+     *
+     * @return true if the boxes start overlapping somewhere along the motion, false otherwise.
+     */
+    static bool sweepAABB(const Rect& moving, float moveX, float moveY, const Rect& target, SweepHit& hit);
+
+    /**
+     * Moves the projectiles and checks for collisions between entities and projectiles.
+     *
+     * This function iterates through the position and hitbox columns of the entity and projectile
+     * registries. Each projectile is swept along its velocity for the tick, so it stops at the first
+     * entity in its path even when it moves farther than that entity is wide. If a collision is detected,
+     * the entity takes damage, the projectile bounces off, and a hit event, plus a kill event if the
+     * entity died, is pushed for scoring and sound to pick up after the tick. The rest of the motion is then
+     * carried on with the reflected velocity, for up to a few bounces per tick.
      *
      * @param entities A reference to the collection of entities to check for collisions.
      * @param projectile A reference to the collection of projectiles to check for collisions.
-     * @param player A reference to the player entity to check for collisions.
-     * @param audio A reference to the audio system to play collision-related audio effects.
-     * @param audio3 A reference to the audio system to play additional collision-related audio effects.
+     * @param broadphase The grid used to find the entities near each projectile's swept hitbox.
+     *                   It is rebuilt here whenever the entity layout changed, and its pair counter
+     *                   is reset and then incremented by every projectile/entity pair tested.
+     * @param events The tick's event buffer, the only thing outside the registries and the grid written to.
      *
      * @return A boolean value indicating whether any collisions were detected (true) or not (false).
      *         The function does not return a specific list of colliding entities or projectiles.
      */
-    static bool checkCollisions(std::vector<Entity>& entities, std::vector<Entity>& projectile, Player& player, Audio& audio, Audio& audio3);
+    static bool checkCollisions(EntityRegistry& entities, EntityRegistry& projectile, UniformGrid& broadphase, GameEventBuffer& events);
+
+    /**
+     * Returns the area covered by a hitbox over a motion.
+     *
+     * @param hitbox The hitbox at the start of the motion.
+     * @param moveX The x-displacement over the motion.
+     * @param moveY The y-displacement over the motion.
+     *
+     * @return The bounding box of the hitbox at its start position and after moving.
+     */
+    static Rect sweptHitbox(const Rect& hitbox, float moveX, float moveY);
 
     /**
      * Applies a bounce effect to a projectile based on the collision with an entity.
@@ -59,22 +98,40 @@ public:
      * the given entity. The bounce effect is simulated by reflecting the projectile's
      * velocity across the normal vector of the collision surface.
      *
-     * @param projectile A reference to the projectile entity that will be bounced.
-     *                   The projectile's velocity will be updated based on the collision.
-     * @param entityHitbox A reference to the SDL_Rect representing the hitbox of the entity
+     * @param projectiles A reference to the registry holding the projectile that will be bounced.
+     * @param index The dense index of the projectile in the registry.
+     *              The projectile's velocity will be updated based on the collision.
+     * @param entityHitbox A reference to the Rect representing the hitbox of the entity
      *                    with which the projectile collides. The hitbox is used to calculate
      *                    the collision normal vector.
      *
      * @return This function does not return a value. It modifies the projectile's velocity
      *         directly.
      */
-    static void bounceProjectile(Entity& projectile, const SDL_Rect& entityHitbox);
+    static void bounceProjectile(EntityRegistry& projectiles, size_t index, const Rect& entityHitbox);
+
+    /**
+     * Moves a projectile to the point where its sweep touched an entity and reflects it there.
+     *
+     * The projectile is placed flush against the face that was hit and moved along the other axis
+     * by the part of the motion covered before contact. The velocity component along the hit normal
+     * is reversed and damped like in the overlap version.
+     *
+     * @param projectiles A reference to the registry holding the projectile that will be bounced.
+     * @param index The dense index of the projectile in the registry.
+     * @param entityHitbox The hitbox of the entity that was hit.
+     * @param hit The result of sweepAABB for this projectile and entity.
+     * @param moveX The x-displacement that was swept.
+     * @param moveY The y-displacement that was swept.
+     */
+    static void bounceProjectile(EntityRegistry& projectiles, size_t index, const Rect& entityHitbox,
+        const SweepHit& hit, float moveX, float moveY);
 
     /**
      * Applies gravity to a collection of projectiles.
      *
-     * This function iterates through the given collection of projectiles and updates
-     * their y-coordinates based on the provided gravity strength. The function assumes
+     * This function iterates through the flag and velocity columns of the given registry and updates
+     * the y-velocity of every projectile that has bounced, based on the provided gravity strength. The function assumes
      * that the projectiles have a velocity component in the y-direction.
      *
      * @param projectiles A reference to the collection of projectiles to which gravity
@@ -86,7 +143,7 @@ public:
      * @return This function does not return a value. It modifies the projectiles'
      *         positions directly.
      */
-    static void applyGravity(std::vector<Entity>& projectiles, float gravityStrength);
+    static void applyGravity(EntityRegistry& projectiles, float gravityStrength);
 
     /**
      * Calculates the impact angle between two entities.
@@ -102,6 +159,12 @@ public:
     static float calculateImpactAngle(float, float);
 
 private:
+    //index of the first packed box overlapping the rect, or SIZE_MAX, tested 16 at a time with AabbKernel
+    static size_t firstOverlap(const Rect& rect, const PackedAabbs& boxes);
+
+    //damage and events for a projectile hitting an entity
+    static void hitEntity(EntityRegistry& entities, size_t entity, EntityRegistry& projectiles, size_t projectile,
+        GameEventBuffer& events);
 };
 
 #endif
\ No newline at end of file
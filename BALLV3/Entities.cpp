@@ -1,8 +1,13 @@
 #include "Entities.h"
+#include "EntityRegistry.h"
+#include "Random.h"
+#include "Profiler.h"
+
+#include <cmath>
 //ENTITIES 
 
-Entity::Entity(float p_x, float p_y, SDL_Texture* p_text, float velX, float velY, bool projectile, int hp, bool is_wall)
-    : x(p_x), y(p_y), texture(p_text), velocityX(velX), velocityY(velY), isProjectile(projectile), health(hp), isWall(is_wall)
+Entity::Entity(float p_x, float p_y, int p_text, float velX, float velY, bool projectile, int hp, bool is_wall)
+    : isWall(is_wall), health(hp), velocityY(velY), velocityX(velX), isProjectile(projectile), x(p_x), y(p_y), texture(p_text)
 {
     currentFrame.x = 0;
     currentFrame.y = 0;
@@ -41,114 +46,68 @@ void Entity::updatePosition() {
 }
 
 
-void Entity::render(SDL_Renderer* renderer)
+namespace
 {
-    SDL_Rect destRect = {
-        static_cast<int>(x),
-        static_cast<int>(y),
-        currentFrame.w,
-        currentFrame.h
-    };
-    SDL_RenderCopy(renderer, texture, &currentFrame, &destRect);
-}
-
+    //one wave in the given band, Poisson-disc spaced as far as the band has room
+    void spawnWave(EntityRegistry& entities, Random& rng, SpawnState& spawn, int entityTexture,
+        float top, float spawnWidth, float spawnHeight)
+    {
+        entities.ensureHeadroom(spawn.entitiesToSpawn);
 
-void Entity::Spawn(SDL_Event& event, std::vector<Entity>& entities, SDL_Texture* entityTexture, int windowWidth, int windowHeight, bool* detectOutOfBound)
-{
-    static int entitiesToSpawn = 3;
-    static int placeholder = 2;
-    static bool initialSpawn = false;
-    static int entityHealth = 2; 
+        const size_t placed = spawn.sampler.place(entities, rng, 0.0f, top, spawnWidth, spawnHeight, spawn.entitiesToSpawn);
+        const std::vector<PoissonSpawner::Point>& points = spawn.sampler.getPoints();
+        for (size_t i = 0; i < placed; ++i) {
+            entities.add(Entity(points[i].x, points[i].y, entityTexture, 0.0f, 0.0f, false, spawn.entityHealth));
+        }
 
-    int spawnWidth = windowWidth - 128;
-    int spawnHeight = windowHeight / 6 - 64;
-    float minimumDistance = 128.0f;
-    int maxAttempts = 10;
+        //no spacing left anywhere in the band, the rest go in at random like they always did
+        for (int i = static_cast<int>(placed); i < spawn.entitiesToSpawn; ++i) {
+            const float randomX = std::floor(rng.nextFloat() * spawnWidth);
+            const float randomY = top + std::floor(rng.nextFloat() * spawnHeight);
+            entities.add(Entity(randomX, randomY, entityTexture, 0.0f, 0.0f, false, spawn.entityHealth));
+        }
+    }
+}
 
-    static bool toggleSpawn = false;
+void Entity::Spawn(EntityRegistry& entities, Random& rng, SpawnState& spawn, int entityTexture, int windowWidth, int windowHeight, bool* detectOutOfBound)
+{
+    PROFILE_ZONE("Spawn");
+    int& entitiesToSpawn = spawn.entitiesToSpawn;
+    int& placeholder = spawn.placeholder;
+    bool& initialSpawn = spawn.initialSpawn;
+    int& entityHealth = spawn.entityHealth;
+    bool& toggleSpawn = spawn.toggleSpawn;
 
-    /* Check spawning location spaced out
-       If it doesn't find any (after 10 tries), spawn randomly */
+    const float spawnWidth = static_cast<float>(windowWidth - 128);
+    const float spawnHeight = static_cast<float>(windowHeight / 6 - 64);
 
+    //the first wave sits just above the bottom band, later ones come in below the screen and scroll up
     if (!initialSpawn)
     {
-        for (int i = 0; i < 3; i++)
-        {
-            float randomX, randomY;
-            bool positionFound = false;
-            int attempts = 0;   
-
-            while (!positionFound && attempts < maxAttempts) {
-                randomX = static_cast<float>(rand() % spawnWidth);
-                randomY = static_cast<float>(windowHeight - spawnHeight - (rand() % spawnHeight));
-                positionFound = true;
-
-                for (const auto& entity : entities) {
-                    float dx = entity.x - randomX;
-                    float dy = entity.y - randomY;
-                    if (std::sqrt(dx * dx + dy * dy) < minimumDistance) {
-                        positionFound = false;
-                        break;
-                    }
-                }
-                attempts++;
-            }
-
-            if (!positionFound && !entities.empty()) {
-                randomX = static_cast<float>(rand() % spawnWidth);
-                randomY = static_cast<float>(windowHeight - spawnHeight - (rand() % spawnHeight));
-            }
-
-            entities.emplace_back(randomX, randomY, entityTexture, 0.0f, 0.0f, false, entityHealth);
-        }
+        spawnWave(entities, rng, spawn, entityTexture, windowHeight - 2 * spawnHeight, spawnWidth, spawnHeight);
         initialSpawn = true;
     }
     if (*detectOutOfBound && toggleSpawn)
     {
         toggleSpawn = false;
-        for (int i = 0; i < entitiesToSpawn; ++i)
-        {
-            float randomX, randomY;
-            bool positionFound = false;
-            int attempts = 0;
-
-            while (!positionFound && attempts < maxAttempts) {
-                randomX = static_cast<float>(rand() % spawnWidth);
-                randomY = static_cast<float>(windowHeight + (rand() % spawnHeight));
-                positionFound = true;
-
-                for (const auto& entity : entities) {
-                    float dx = entity.x - randomX;
-                    float dy = entity.y - randomY;
-                    if (std::sqrt(dx * dx + dy * dy) < minimumDistance) {
-                        positionFound = false;
-                        break;
-                    }
-                }
-                attempts++;
-            }
-
-            if (!positionFound && !entities.empty()) {
-                randomX = static_cast<float>(rand() % spawnWidth);
-                randomY = static_cast<float>(windowHeight + spawnHeight - (rand() % spawnHeight));
-            }
-
-            entities.emplace_back(randomX, randomY, entityTexture, 0.0f, 0.0f, false, entityHealth);
-        }
+        spawnWave(entities, rng, spawn, entityTexture, static_cast<float>(windowHeight), spawnWidth, spawnHeight);
 
-        if (placeholder % 5 == 0) {
+        if (placeholder % spawn.wavesPerRamp == 0) {
             entitiesToSpawn++;
             entityHealth++; 
         }
         placeholder++;
 
-        for (auto& entity : entities)
+        float* entityY = entities.getPositionsY();
+        const uint8_t* entityFlags = entities.getFlags();
+        for (size_t i = 0; i < entities.size(); ++i)
         {
-            if (!entity.isProjectile && !entity.isWall)
+            if (!(entityFlags[i] & (ENTITY_PROJECTILE | ENTITY_WALL)))
             {
-                entity.y -= 128.0f;
+                entityY[i] -= 128.0f;
             }
         }
+        entities.markMoved();
     }
     else if (*detectOutOfBound)
     {
@@ -186,9 +145,9 @@ void Entity::setPositionY(float newY)
     y = newY;
 }
 
-SDL_Rect Entity::getHitbox() const
+Rect Entity::getHitbox() const
 {
-    SDL_Rect rect;
+    Rect rect;
     if (isProjectile)
     {
         rect.x = static_cast<int>(x);
@@ -251,7 +210,7 @@ int Entity::getHealth()const
     return health;
 }
 
-SDL_Texture* Entity::getTexture()
+int Entity::getTexture() const
 {
     return texture;
 }
@@ -264,7 +223,7 @@ bool Entity::getHasCollided() const {
 void Entity::setHasCollided(bool state) {
     hasCollided = state;
 }
-SDL_Rect& Entity::getCurrentFrame() {
+Rect& Entity::getCurrentFrame() {
     return currentFrame;
 }
 
@@ -1,15 +1,35 @@
 #pragma once
 #ifndef Entity_h
 #define Entity_h
-#include <SDL.h>
-#include <SDL_image.h>
 #include <iostream>
 #include <vector>
-#include <random>
-#include <ctime>
+
+#include "SimTypes.h"
+#include "PoissonSpawner.h"
 
 const int max_entities = 32;
 
+class EntityRegistry;
+class Random;
+
+//wave bookkeeping of Entity::Spawn, one per world
+struct SpawnState
+{
+	//planets in the next wave
+	int entitiesToSpawn = 3;
+	//hits a new planet takes
+	int entityHealth = 2;
+	//waves between ramps: one more planet per wave and one more hit per planet
+	int wavesPerRamp = 5;
+	//wave counter, starts at 2 so the first ramp comes after the third wave
+	int placeholder = 2;
+	bool initialSpawn = false;
+	//a wave scrolls in on every second out-of-bounds tick
+	bool toggleSpawn = false;
+	//places every wave 128 px apart, keeps its grid between waves so spawning doesn't allocate
+	PoissonSpawner sampler;
+};
+
 class Entity 
 {
 public:
@@ -18,7 +38,7 @@ public:
 	 *
 	 * @param p_x: The initial x-coordinate of the entity.
 	 * @param p_y: The initial y-coordinate of the entity.
-	 * @param p_text: The SDL_Texture object representing the entity's image.
+	 * @param p_text: The ID of the texture representing the entity's image.
 	 * @param velX: The initial horizontal velocity of the entity (default: 0.0f).
 	 * @param velY: The initial vertical velocity of the entity (default: 0.0f).
 	 * @param projectile: Indicates whether the entity is a projectile (default: false).
@@ -26,7 +46,7 @@ public:
 	 * @param is_wall: Indicates whether the entity is a wall (default: false).
 	 * @param is_powerUp: Indicates whether the entity is a power-up (default: false).
 	 */
-	Entity(float p_x, float p_y, SDL_Texture* p_text,
+	Entity(float p_x, float p_y, int p_text,
 		float velX = 0.0f, float velY = 0.0f,
 		bool projectile = false, int hp = 1,
 		bool is_wall = false);
@@ -38,31 +58,22 @@ public:
 	 * It checks for user input events, verifies the entity count, and determines the entity's initial position
 	 * and velocity based on the game state.
 	 *
-	 * @param event: The SDL_Event object representing the user input event.
-	 * @param entities: A reference to the std::vector<Entity> container holding all existing entities in the game.
-	 * @param entityTexture: The SDL_Texture object representing the image to be used for the new entity.
+	 * Each wave is placed by spawn.sampler at least 128 px from every other planet whenever the band has room,
+	 * planets that don't fit anywhere spaced go in at random.
+	 *
+	 * @param entities: A reference to the EntityRegistry holding all existing entities in the game.
+	 * @param rng: The world's generator, every spawn position is drawn from it.
+	 * @param spawn: The wave state of the world being spawned into.
+	 * @param entityTexture: The ID of the texture to be used for the new entity.
 	 * @param windowWidth: The width of the game window.
 	 * @param windowHeight: The height of the game window.
 	 * @param detectOutOfBound: A pointer to a boolean variable indicating whether an entity has gone out of bounds.
 	 *
 	 * @return void: This function does not return any value.
 	 */
-	static void Spawn(SDL_Event& event,
-		std::vector<Entity>& entities, SDL_Texture* entityTexture,
+	static void Spawn(EntityRegistry& entities, Random& rng, SpawnState& spawn, int entityTexture,
 		int windowWidth, int windowHeight, bool* detectOutOfBound);
 
-	/**
-	 * Renders the entity on the specified SDL_Renderer.
-	 *
-	 * This function uses the entity's texture and current frame rectangle to render the entity on the given SDL_Renderer.
-	 * The rendering is done at the entity's current position (x, y) within the game world.
-	 *
-	 * @param renderer: A pointer to the SDL_Renderer object on which the entity will be rendered.
-	 *
-	 * @return void: This function does not return any value.
-	 */
-	void render(SDL_Renderer* renderer);
-
 	/**
 	 * Updates the position of the entity based on its current velocity.
 	 *
@@ -85,14 +96,14 @@ public:
 	bool takeDamage();
 
 	/**
-	 * Retrieves the SDL_Texture object associated with the entity.
+	 * Retrieves the ID of the texture associated with the entity.
 	 *
-	 * This function returns a pointer to the SDL_Texture object that represents the image
-	 * of the entity. The texture is used for rendering the entity on the SDL_Renderer.
+	 * This function returns the ID of the texture that represents the image
+	 * of the entity. RenderWindow maps the ID to the texture used for rendering.
 	 *
-	 * @return SDL_Texture*: A pointer to the SDL_Texture object associated with the entity.
+	 * @return int: The texture ID associated with the entity.
 	 */
-	SDL_Texture* getTexture();
+	int getTexture() const;
 
 
 
@@ -115,25 +126,25 @@ public:
 	/**
 	 * Retrieves the current frame rectangle of the entity.
 	 *
-	 * This function returns a reference to the SDL_Rect object that represents the current frame
+	 * This function returns a reference to the Rect object that represents the current frame
 	 * of the entity's animation. The current frame is used to determine which part of the texture
 	 * should be rendered on the screen.
 	 *
-	 * @return SDL_Rect&: A reference to the current frame rectangle of the entity.
-	 *                     The returned SDL_Rect object contains the position and dimensions of the current frame.
+	 * @return Rect&: A reference to the current frame rectangle of the entity.
+	 *                 The returned Rect object contains the position and dimensions of the current frame.
 	 */
-	SDL_Rect& getCurrentFrame();
+	Rect& getCurrentFrame();
 	/**
 	 * Retrieves the hitbox rectangle of the entity.
 	 *
 	 * The hitbox represents the area of the entity that can be collided with other entities.
-	 * This function returns a SDL_Rect object that contains the position and dimensions of the hitbox.
+	 * This function returns a Rect object that contains the position and dimensions of the hitbox.
 	 *
-	 * @return SDL_Rect: A SDL_Rect object representing the hitbox of the entity.
-	 *                   The returned SDL_Rect object contains the position (x, y) and dimensions (w, h) of the hitbox.
+	 * @return Rect: A Rect object representing the hitbox of the entity.
+	 *               The returned Rect object contains the position (x, y) and dimensions (w, h) of the hitbox.
 	 *                   The position and dimensions are relative to the game world.
 	 */
-	SDL_Rect getHitbox() const;
+	Rect getHitbox() const;
 
 	//grouping of getter functions
 	float getX() const;
@@ -148,6 +159,8 @@ public:
 
 
 private:
+	friend class EntityRegistry;
+
 	bool isWall;
 	int baseHealth;
 	int health;
@@ -156,8 +169,8 @@ private:
 	float velocityX;
 	bool isProjectile;
 	float x, y;
-	SDL_Rect currentFrame;
-	SDL_Texture* texture;
+	Rect currentFrame;
+	int texture;
 
 	double collisionDelay = 0.0f;
 
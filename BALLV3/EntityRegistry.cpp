@@ -0,0 +1,276 @@
+#include "EntityRegistry.h"
+
+EntityHandle EntityRegistry::add(const Entity& entity)
+{
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<uint32_t>(slotToDense.size());
+        slotToDense.push_back(0);
+        slotGeneration.push_back(0);
+    }
+
+    const Rect hitbox = entity.getHitbox();
+    uint8_t entityFlags = 0;
+    if (entity.isProjectile) entityFlags |= ENTITY_PROJECTILE;
+    if (entity.isWall) entityFlags |= ENTITY_WALL;
+    if (entity.hasCollided) entityFlags |= ENTITY_COLLIDED;
+
+    slotToDense[slot] = static_cast<uint32_t>(x.size());
+    denseToSlot.push_back(slot);
+
+    x.push_back(entity.x);
+    y.push_back(entity.y);
+    velocityX.push_back(entity.velocityX);
+    velocityY.push_back(entity.velocityY);
+    hitWidth.push_back(static_cast<float>(hitbox.w));
+    hitHeight.push_back(static_cast<float>(hitbox.h));
+    flags.push_back(entityFlags);
+    health.push_back(entity.health);
+    cold.push_back({ entity.texture, entity.currentFrame, entity.baseHealth, entity.collisionDelay });
+    layoutVersion++;
+
+    return { slot, slotGeneration[slot] };
+}
+
+void EntityRegistry::remove(size_t index)
+{
+    size_t last = x.size() - 1;
+    uint32_t removedSlot = denseToSlot[index];
+    if (flags[index] & ENTITY_DEAD) {
+        pendingRemovals--;
+    }
+
+    if (index != last) {
+        x[index] = x[last];
+        y[index] = y[last];
+        velocityX[index] = velocityX[last];
+        velocityY[index] = velocityY[last];
+        hitWidth[index] = hitWidth[last];
+        hitHeight[index] = hitHeight[last];
+        flags[index] = flags[last];
+        health[index] = health[last];
+        cold[index] = cold[last];
+        denseToSlot[index] = denseToSlot[last];
+        slotToDense[denseToSlot[index]] = static_cast<uint32_t>(index);
+    }
+
+    x.pop_back();
+    y.pop_back();
+    velocityX.pop_back();
+    velocityY.pop_back();
+    hitWidth.pop_back();
+    hitHeight.pop_back();
+    flags.pop_back();
+    health.pop_back();
+    cold.pop_back();
+    denseToSlot.pop_back();
+
+    //bump the generation so old handles to this slot go stale
+    slotGeneration[removedSlot]++;
+    freeSlots.push_back(removedSlot);
+    layoutVersion++;
+}
+
+void EntityRegistry::remove(EntityHandle handle)
+{
+    if (isAlive(handle)) {
+        remove(indexOf(handle));
+    }
+}
+
+void EntityRegistry::kill(size_t index)
+{
+    if (!(flags[index] & ENTITY_DEAD)) {
+        flags[index] |= ENTITY_DEAD;
+        pendingRemovals++;
+    }
+}
+
+size_t EntityRegistry::flushRemovals()
+{
+    const size_t removed = pendingRemovals;
+    //walk backwards so the body swapped into a freed index has already been checked
+    for (size_t i = x.size(); i-- > 0 && pendingRemovals > 0; ) {
+        if (flags[i] & ENTITY_DEAD) {
+            remove(i);
+        }
+    }
+    return removed;
+}
+
+void EntityRegistry::ensureHeadroom(size_t extra)
+{
+    const size_t needed = x.size() + extra;
+    if (needed > x.capacity()) {
+        reserve(needed > 2 * x.capacity() ? needed : 2 * x.capacity());
+    }
+}
+
+size_t EntityRegistry::capacity() const
+{
+    return x.capacity();
+}
+
+bool EntityRegistry::isAlive(EntityHandle handle) const
+{
+    return handle.slot < slotGeneration.size() && slotGeneration[handle.slot] == handle.generation
+        && slotToDense[handle.slot] < denseToSlot.size() && denseToSlot[slotToDense[handle.slot]] == handle.slot;
+}
+
+size_t EntityRegistry::indexOf(EntityHandle handle) const
+{
+    return slotToDense[handle.slot];
+}
+
+EntityHandle EntityRegistry::handleAt(size_t index) const
+{
+    uint32_t slot = denseToSlot[index];
+    return { slot, slotGeneration[slot] };
+}
+
+size_t EntityRegistry::size() const
+{
+    return x.size();
+}
+
+bool EntityRegistry::empty() const
+{
+    return x.empty();
+}
+
+void EntityRegistry::reserve(size_t capacity)
+{
+    x.reserve(capacity);
+    y.reserve(capacity);
+    velocityX.reserve(capacity);
+    velocityY.reserve(capacity);
+    hitWidth.reserve(capacity);
+    hitHeight.reserve(capacity);
+    flags.reserve(capacity);
+    health.reserve(capacity);
+    cold.reserve(capacity);
+    denseToSlot.reserve(capacity);
+    slotToDense.reserve(capacity);
+    slotGeneration.reserve(capacity);
+    freeSlots.reserve(capacity);
+}
+
+void EntityRegistry::clear()
+{
+    for (uint32_t slot : denseToSlot) {
+        slotGeneration[slot]++;
+        freeSlots.push_back(slot);
+    }
+    x.clear();
+    y.clear();
+    velocityX.clear();
+    velocityY.clear();
+    hitWidth.clear();
+    hitHeight.clear();
+    flags.clear();
+    health.clear();
+    cold.clear();
+    denseToSlot.clear();
+    pendingRemovals = 0;
+    layoutVersion++;
+}
+
+void EntityRegistry::markMoved()
+{
+    layoutVersion++;
+}
+
+uint32_t EntityRegistry::getLayoutVersion() const
+{
+    return layoutVersion;
+}
+
+Rect EntityRegistry::getHitbox(size_t index) const
+{
+    Rect rect;
+    rect.x = static_cast<int>(x[index]);
+    rect.y = static_cast<int>(y[index]);
+    rect.w = static_cast<int>(hitWidth[index]);
+    rect.h = static_cast<int>(hitHeight[index]);
+    return rect;
+}
+
+bool EntityRegistry::takeDamage(size_t index)
+{
+    if (health[index] > 0) {
+        health[index] -= 1;
+    }
+    return health[index] <= 0;
+}
+
+void EntityRegistry::updatePositions()
+{
+    const size_t count = x.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (flags[i] & ENTITY_PROJECTILE) {
+            x[i] += velocityX[i];
+            y[i] += velocityY[i];
+        }
+    }
+}
+
+bool EntityRegistry::hasFlag(size_t index, uint8_t flag) const
+{
+    return (flags[index] & flag) != 0;
+}
+
+void EntityRegistry::setFlag(size_t index, uint8_t flag, bool state)
+{
+    if (state) {
+        flags[index] |= flag;
+    }
+    else {
+        flags[index] &= static_cast<uint8_t>(~flag);
+    }
+}
+
+float* EntityRegistry::getPositionsX() { return x.data(); }
+float* EntityRegistry::getPositionsY() { return y.data(); }
+float* EntityRegistry::getVelocitiesX() { return velocityX.data(); }
+float* EntityRegistry::getVelocitiesY() { return velocityY.data(); }
+uint8_t* EntityRegistry::getFlags() { return flags.data(); }
+int* EntityRegistry::getHealths() { return health.data(); }
+const float* EntityRegistry::getPositionsX() const { return x.data(); }
+const float* EntityRegistry::getPositionsY() const { return y.data(); }
+const float* EntityRegistry::getVelocitiesX() const { return velocityX.data(); }
+const float* EntityRegistry::getVelocitiesY() const { return velocityY.data(); }
+const float* EntityRegistry::getHitWidths() const { return hitWidth.data(); }
+const float* EntityRegistry::getHitHeights() const { return hitHeight.data(); }
+const uint8_t* EntityRegistry::getFlags() const { return flags.data(); }
+const int* EntityRegistry::getHealths() const { return health.data(); }
+
+int EntityRegistry::getTexture(size_t index) const
+{
+    return cold[index].texture;
+}
+
+const Rect& EntityRegistry::getCurrentFrame(size_t index) const
+{
+    return cold[index].currentFrame;
+}
+
+void EntityRegistry::setCollisionDelay(size_t index, double delay)
+{
+    cold[index].collisionDelay = delay;
+}
+
+bool EntityRegistry::canCollide(size_t index) const
+{
+    return cold[index].collisionDelay <= 0;
+}
+
+void EntityRegistry::updateDelay(size_t index, double time)
+{
+    if (cold[index].collisionDelay > 0.0f) {
+        cold[index].collisionDelay -= time;
+    }
+}
@@ -0,0 +1,217 @@
+#pragma once
+#ifndef EntityRegistry_h
+#define EntityRegistry_h
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Entities.h"
+
+/*
+* per-body flags, packed into one byte so the hot loops only pull
+* a single byte per entity when they need to tell planets, walls and projectiles apart
+*/
+enum EntityFlags : uint8_t
+{
+	ENTITY_PROJECTILE = 1 << 0,
+	ENTITY_WALL = 1 << 1,
+	ENTITY_COLLIDED = 1 << 2,
+	//killed this tick, still stored until flushRemovals so indices stay put while systems iterate
+	ENTITY_DEAD = 1 << 3
+};
+
+/**
+ * Stable reference to a body stored in an EntityRegistry.
+ *
+ * The dense index of a body changes whenever another body is removed (swap-and-pop),
+ * the handle does not. A handle whose generation no longer matches its slot refers
+ * to a body that has been removed.
+ */
+struct EntityHandle
+{
+	uint32_t slot = UINT32_MAX;
+	uint32_t generation = 0;
+};
+
+class EntityRegistry
+{
+public:
+	/**
+	 * Copies an Entity into the registry, splitting it into the hot and cold columns.
+	 *
+	 * @param entity: The entity to store. Its hitbox and current frame are captured at insertion.
+	 *
+	 * @return EntityHandle: A stable handle to the stored body.
+	 */
+	EntityHandle add(const Entity& entity);
+
+	/**
+	 * Removes the body at the given dense index in O(1).
+	 *
+	 * The last body is moved into the freed index, so a loop that removes while iterating
+	 * must not advance its index after a removal.
+	 *
+	 * @param index: The dense index of the body to remove.
+	 */
+	void remove(size_t index);
+
+	/**
+	 * Removes the body referred to by the handle. Does nothing if the handle is stale.
+	 *
+	 * @param handle: The handle of the body to remove.
+	 */
+	void remove(EntityHandle handle);
+
+	/**
+	 * Marks the body at the given dense index for removal at the end of the tick.
+	 *
+	 * The body keeps its index and its columns until flushRemovals, so loops can kill while
+	 * iterating without adjusting their index and caches built from the layout stay valid.
+	 * Systems skip bodies flagged ENTITY_DEAD.
+	 *
+	 * @param index: The dense index of the body to kill.
+	 */
+	void kill(size_t index);
+
+	/**
+	 * Removes every killed body with swap-and-pop. Called once at the end of each tick.
+	 *
+	 * @return size_t: The number of bodies removed.
+	 */
+	size_t flushRemovals();
+
+	/**
+	 * Makes room for extra more bodies so the next adds don't allocate.
+	 *
+	 * Capacity grows to at least twice its old size when it has to grow at all, so a game whose
+	 * bursts and waves stop growing reaches a fixed capacity and stops allocating.
+	 *
+	 * @param extra: The number of bodies about to be added.
+	 */
+	void ensureHeadroom(size_t extra);
+	size_t capacity() const;
+
+	/**
+	 * Checks whether a handle still refers to a body in the registry.
+	 *
+	 * @param handle: The handle to check.
+	 *
+	 * @return bool: true if the body is still stored, false if it has been removed.
+	 */
+	bool isAlive(EntityHandle handle) const;
+
+	/**
+	 * Converts a live handle to the current dense index of its body.
+	 *
+	 * @param handle: A live handle (see isAlive).
+	 *
+	 * @return size_t: The dense index of the body.
+	 */
+	size_t indexOf(EntityHandle handle) const;
+
+	/**
+	 * Returns the stable handle of the body currently stored at a dense index.
+	 *
+	 * @param index: The dense index of the body.
+	 *
+	 * @return EntityHandle: The handle of that body.
+	 */
+	EntityHandle handleAt(size_t index) const;
+
+	/**
+	 * Marks the layout of the registry as changed after positions were moved in bulk
+	 * (e.g. a wave shift), so anything cached from the positions gets rebuilt.
+	 */
+	void markMoved();
+
+	/**
+	 * Counter bumped on every add, remove, clear and markMoved.
+	 *
+	 * @return uint32_t: The current layout version.
+	 */
+	uint32_t getLayoutVersion() const;
+
+	size_t size() const;
+	bool empty() const;
+	void reserve(size_t capacity);
+	void clear();
+
+	/**
+	 * Hitbox of the body at the given index, identical to Entity::getHitbox.
+	 *
+	 * @param index: The dense index of the body.
+	 *
+	 * @return Rect: The hitbox of the body in world coordinates.
+	 */
+	Rect getHitbox(size_t index) const;
+
+	/**
+	 * Reduces the health of the body at the given index by one point.
+	 *
+	 * @param index: The dense index of the body.
+	 *
+	 * @return bool: true if the body's health reached zero or below.
+	 */
+	bool takeDamage(size_t index);
+
+	/**
+	 * Moves every projectile by its velocity. Only the position, velocity and flag columns are touched.
+	 */
+	void updatePositions();
+
+	bool hasFlag(size_t index, uint8_t flag) const;
+	void setFlag(size_t index, uint8_t flag, bool state);
+
+	//hot columns, one contiguous array per field
+	float* getPositionsX();
+	float* getPositionsY();
+	float* getVelocitiesX();
+	float* getVelocitiesY();
+	uint8_t* getFlags();
+	int* getHealths();
+	const float* getPositionsX() const;
+	const float* getPositionsY() const;
+	const float* getVelocitiesX() const;
+	const float* getVelocitiesY() const;
+	const float* getHitWidths() const;
+	const float* getHitHeights() const;
+	const uint8_t* getFlags() const;
+	const int* getHealths() const;
+
+	//cold data, only read when rendering or on collision
+	int getTexture(size_t index) const;
+	const Rect& getCurrentFrame(size_t index) const;
+	void setCollisionDelay(size_t index, double delay);
+	bool canCollide(size_t index) const;
+	void updateDelay(size_t index, double time);
+
+private:
+	struct ColdData
+	{
+		int texture;
+		Rect currentFrame;
+		int baseHealth;
+		double collisionDelay;
+	};
+
+	//hot
+	std::vector<float> x, y;
+	std::vector<float> velocityX, velocityY;
+	std::vector<float> hitWidth, hitHeight;
+	std::vector<uint8_t> flags;
+	std::vector<int> health;
+
+	//cold
+	std::vector<ColdData> cold;
+
+	//handle bookkeeping
+	std::vector<uint32_t> denseToSlot;
+	std::vector<uint32_t> slotToDense;
+	std::vector<uint32_t> slotGeneration;
+	std::vector<uint32_t> freeSlots;
+
+	uint32_t layoutVersion = 0;
+	size_t pendingRemovals = 0;
+};
+
+#endif // EntityRegistry_h
@@ -0,0 +1,69 @@
+#include "FixedTimestep.h"
+
+#include <chrono>
+#include <thread>
+
+FixedTimestep::FixedTimestep(double ticksPerSecond, int maxTicksPerFrame)
+    : maxTicksPerFrame(maxTicksPerFrame)
+{
+    frequency = SDL_GetPerformanceFrequency();
+    tickLength = static_cast<uint64_t>(frequency / ticksPerSecond);
+    lastCounter = SDL_GetPerformanceCounter();
+}
+
+int FixedTimestep::advance()
+{
+    const uint64_t now = SDL_GetPerformanceCounter();
+    accumulator += now - lastCounter;
+    lastCounter = now;
+
+    uint64_t due = accumulator / tickLength;
+    if (due > static_cast<uint64_t>(maxTicksPerFrame)) {
+        //spiral-of-death guard: forget the time we can't afford to catch up on
+        droppedTicks += due - maxTicksPerFrame;
+        accumulator = accumulator % tickLength;
+        due = maxTicksPerFrame;
+    }
+    else {
+        accumulator -= due * tickLength;
+    }
+
+    tickCount += due;
+    return static_cast<int>(due);
+}
+
+void FixedTimestep::waitForNextTick() const
+{
+    const uint64_t deadline = lastCounter + (tickLength - accumulator);
+    const uint64_t millisecond = frequency / 1000;
+    for (uint64_t now = SDL_GetPerformanceCounter(); now < deadline; now = SDL_GetPerformanceCounter()) {
+        const uint64_t left = deadline - now;
+        //rounded down, so SDL_Delay's millisecond granularity can't sleep past the deadline by much
+        if (left >= millisecond) {
+            SDL_Delay(static_cast<Uint32>(left / millisecond));
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(left * 1000000000 / frequency));
+        }
+    }
+}
+
+double FixedTimestep::getAlpha() const
+{
+    return static_cast<double>(accumulator) / tickLength;
+}
+
+double FixedTimestep::getTickSeconds() const
+{
+    return static_cast<double>(tickLength) / frequency;
+}
+
+uint64_t FixedTimestep::getTickCount() const
+{
+    return tickCount;
+}
+
+uint64_t FixedTimestep::getDroppedTicks() const
+{
+    return droppedTicks;
+}
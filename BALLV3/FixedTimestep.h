@@ -0,0 +1,65 @@
+#pragma once
+#ifndef FixedTimestep_h
+#define FixedTimestep_h
+#include <SDL.h>
+#include <cstdint>
+
+/*
+* accumulator-based scheduler: real time measured with SDL_GetPerformanceCounter
+* is banked and paid out in fixed simulation ticks, so gameplay runs at the same speed
+* no matter how long rendering takes
+*/
+class FixedTimestep
+{
+public:
+    /**
+     * Creates a scheduler and starts its clock.
+     *
+     * @param ticksPerSecond The simulation rate. All per-tick speeds in the game are tuned for 32.
+     * @param maxTicksPerFrame The most ticks advance() hands out at once. Time beyond that is dropped
+     *                         instead of being caught up, so a stall can't snowball into longer and longer frames.
+     */
+    FixedTimestep(double ticksPerSecond, int maxTicksPerFrame);
+
+    /**
+     * Banks the real time elapsed since the last call and returns how many ticks are due.
+     *
+     * @return The number of simulation ticks to run before the next render, between 0 and maxTicksPerFrame.
+     */
+    int advance();
+
+    /**
+     * Sleeps until the next tick is due.
+     *
+     * Sleeps the whole milliseconds left with SDL_Delay, then the sub-millisecond rest with
+     * std::this_thread::sleep_for; it never spins, so the wake-up may come late by the OS's timer slack.
+     */
+    void waitForNextTick() const;
+
+    /**
+     * How far real time has got into the next tick, as of the last advance().
+     * Rendering moves bodies along by this fraction of a tick so motion stays smooth between ticks.
+     *
+     * @return The banked time left over after paying out the due ticks, from 0 up to 1 tick.
+     */
+    double getAlpha() const;
+
+    //length of one tick in seconds
+    double getTickSeconds() const;
+    //ticks run since the scheduler was created
+    uint64_t getTickCount() const;
+    //ticks dropped by the catch-up limit
+    uint64_t getDroppedTicks() const;
+
+private:
+    uint64_t frequency;
+    uint64_t tickLength;
+    uint64_t lastCounter;
+    uint64_t accumulator = 0;
+    int maxTicksPerFrame;
+
+    uint64_t tickCount = 0;
+    uint64_t droppedTicks = 0;
+};
+
+#endif
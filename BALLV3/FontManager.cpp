@@ -1,4 +1,5 @@
 #include "FontManager.h"
+#include "AssetArchive.h"
 #include <iostream>
 
 FontManager& FontManager::Instance() {
@@ -7,42 +8,47 @@ FontManager& FontManager::Instance() {
 }
 
 bool FontManager::LoadFont(const std::string& fontID, const std::string& path, int fontSize) {
-    TTF_Font* font = TTF_OpenFont(path.c_str(), fontSize);
+    SDL_RWops* packed = AssetArchive::Instance().openFile(path);
+    TTF_Font* font = packed ? TTF_OpenFontRW(packed, 1, fontSize) : TTF_OpenFont(path.c_str(), fontSize);
     if (!font) {
         std::cout << "Failed to load font: " << TTF_GetError() << std::endl;
         return false;
     }
+    auto loaded = fonts.find(fontID);
+    if (loaded != fonts.end()) {
+        TTF_CloseFont(loaded->second);
+    }
     fonts[fontID] = font;
+    //rasterized again from the new font on the next GetGlyphs
+    glyphs.erase(fontID);
     return true;
 }
 
 void FontManager::RenderText(const std::string& fontID, const std::string& text, SDL_Color color, int x, int y, SDL_Renderer* renderer) {
-    TTF_Font* font = fonts[fontID];
-    if (!font) {
+    GlyphAtlas* atlas = GetGlyphs(fontID);
+    if (!atlas) {
         std::cout << "Font ID not good: " << fontID << std::endl;
         return;
     }
 
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), color);
-    if (!textSurface) {
-        std::cout << "text rendering not good TTF_Error: " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    SDL_FreeSurface(textSurface);
+    textBatch.setRenderer(renderer);
+    atlas->draw(textBatch, renderer, text.c_str(), color, x, y);
+    textBatch.flush();
+}
 
-    if (!textTexture) {
-        std::cout << "texture from rendered text not good SDL_Error: " << SDL_GetError() << std::endl;
+void FontManager::RenderScore(const std::string& fontID, SDL_Color color, int x, int y, SDL_Renderer* renderer, Player& player) {
+    if (!GetScoreTexture(fontID, color, renderer, player)) {
         return;
     }
 
-    SDL_Rect textRect = { x, y, textSurface->w, textSurface->h };
-    SDL_RenderCopy(renderer, textTexture, nullptr, &textRect);
-    SDL_DestroyTexture(textTexture);
+    int textWidth, textHeight;
+    SDL_QueryTexture(cachedScoreTexture, nullptr, nullptr, &textWidth, &textHeight);
+    SDL_Rect textRect = { x, y, textWidth, textHeight };
+
+    SDL_RenderCopy(renderer, cachedScoreTexture, nullptr, &textRect);
 }
 
-void FontManager::RenderScore(const std::string& fontID, SDL_Color color, int x, int y, SDL_Renderer* renderer, Player& player) {
+SDL_Texture* FontManager::GetScoreTexture(const std::string& fontID, SDL_Color color, SDL_Renderer* renderer, Player& player) {
     int score = player.getScore();
     if (score != lastScore) {
         lastScore = score;
@@ -55,40 +61,70 @@ void FontManager::RenderScore(const std::string& fontID, SDL_Color color, int x,
         TTF_Font* font = fonts[fontID];
         if (!font) {
             std::cout << "Font ID not good: " << fontID << std::endl;
-            return;
+            return nullptr;
         }
 
         SDL_Surface* textSurface = TTF_RenderText_Solid(font, scoreText.c_str(), color);
         if (!textSurface) {
             std::cout << "text rendering not good TTF_Error: " << TTF_GetError() << std::endl;
-            return;
+            return nullptr;
         }
 
         cachedScoreTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
         SDL_FreeSurface(textSurface);
         if (!cachedScoreTexture) {
             std::cout << "texture from rendered text not good SDL_Error: " << SDL_GetError() << std::endl;
-            return;
+            return nullptr;
         }
     }
 
-    int textWidth, textHeight;
-    SDL_QueryTexture(cachedScoreTexture, nullptr, nullptr, &textWidth, &textHeight);
-    SDL_Rect textRect = { x, y, textWidth, textHeight };
+    return cachedScoreTexture;
+}
 
-    SDL_RenderCopy(renderer, cachedScoreTexture, nullptr, &textRect);
+GlyphAtlas* FontManager::GetGlyphs(const std::string& fontID) {
+    auto atlas = glyphs.find(fontID);
+    if (atlas != glyphs.end()) {
+        return atlas->second.get();
+    }
+
+    TTF_Font* font = GetFont(fontID);
+    if (!font) {
+        return nullptr;
+    }
+    std::unique_ptr<GlyphAtlas> built(new GlyphAtlas());
+    if (!built->build(font)) {
+        std::cout << "Could not build the glyph atlas of font " << fontID << std::endl;
+    }
+    GlyphAtlas* result = built.get();
+    glyphs[fontID] = std::move(built);
+    return result;
 }
 
+TTF_Font* FontManager::GetFont(const std::string& fontID) const {
+    auto font = fonts.find(fontID);
+    return font != fonts.end() ? font->second : nullptr;
+}
 
-void FontManager::CleanUp() {
-    for (auto& font : fonts) {
-        TTF_CloseFont(font.second);
+void FontManager::ReleaseTextures() {
+    for (auto& atlas : glyphs) {
+        atlas.second->releaseTexture();
     }
-    fonts.clear();
+    textBatch.setRenderer(nullptr);
 
     if (cachedScoreTexture) {
         SDL_DestroyTexture(cachedScoreTexture);
         cachedScoreTexture = nullptr;
     }
+    lastScore = -1;
+}
+
+void FontManager::CleanUp() {
+    ReleaseTextures();
+    glyphs.clear();
+
+    for (auto& font : fonts) {
+        TTF_CloseFont(font.second);
+    }
+    fonts.clear();
 }
 
@@ -6,7 +6,10 @@
 #include <SDL_ttf.h>
 #include <string>
 #include <map>
+#include <memory>
+#include "GlyphAtlas.h"
 #include "Player.h"
+#include "SpriteBatch.h"
 class FontManager {
 public:
     /**
@@ -22,7 +25,7 @@ public:
     /**
      * @brief Loads a font from the specified file and stores it in the font manager.
      *
-     * This function uses SDL_ttf library to load a font from the given file path.
+     * This function uses SDL_ttf library to load a font from the given file path, or from the asset archive when it has it.
      * The loaded font is stored in the font manager with the given fontID for later use.
      *
      * @param fontID A unique identifier for the font.
@@ -36,8 +39,9 @@ public:
     /**
      * @brief Renders the specified text using the loaded font and color at the given position.
      *
-     * This function uses the loaded font with the given fontID and renders the specified text
-     * using the provided color at the given position (x, y) on the SDL_Renderer.
+     * This function uses the glyph atlas of the font with the given fontID and draws the specified text
+     * using the provided color at the given position (x, y) on the SDL_Renderer, in one batched draw.
+     * Nothing is rasterized or uploaded, except the atlas texture the first time a renderer draws with it.
      *
      * @param fontID The unique identifier of the font to be used for rendering.
      * @param text The text to be rendered.
@@ -64,11 +68,54 @@ public:
      */
     void RenderScore(const std::string& fontID, SDL_Color color, int x, int y, SDL_Renderer* renderer, Player& player);
 
+    /**
+     * @brief Retrieves the texture of the player's score text, to draw it some other way than RenderScore.
+     *
+     * The texture is only rendered again if the score has changed since the last call to this function
+     * or to RenderScore, and it stays valid until then.
+     *
+     * @param fontID The unique identifier of the font to be used for rendering.
+     * @param color The color of the score text.
+     * @param renderer The SDL_Renderer the texture is created for.
+     * @param player The reference to the Player object whose score needs to be rendered.
+     *
+     * @return The cached score texture, or nullptr if it could not be rendered.
+     */
+    SDL_Texture* GetScoreTexture(const std::string& fontID, SDL_Color color, SDL_Renderer* renderer, Player& player);
+
+    /**
+     * @brief Retrieves the glyph atlas of a loaded font, rasterizing it on the first call.
+     *
+     * Callers drawing text every frame keep the pointer, it stays valid until CleanUp.
+     *
+     * @param fontID The unique identifier the font was loaded with.
+     *
+     * @return The GlyphAtlas, or nullptr if no font was loaded with that ID.
+     */
+    GlyphAtlas* GetGlyphs(const std::string& fontID);
+
+    /**
+     * @brief Retrieves a loaded font.
+     *
+     * @param fontID The unique identifier the font was loaded with.
+     *
+     * @return The TTF_Font, or nullptr if no font was loaded with that ID.
+     */
+    TTF_Font* GetFont(const std::string& fontID) const;
+
+    /**
+     * @brief Destroys every texture made for a renderer: the glyph atlas textures and the cached score texture.
+     *
+     * Call before destroying the renderer text was drawn with. Fonts and glyph atlases are kept,
+     * their textures are uploaded again for the next renderer that draws.
+     */
+    void ReleaseTextures();
+
     /**
      * @brief Cleans up and frees all resources associated with the FontManager.
      *
      * This function iterates through the loaded fonts, frees each TTF_Font using TTF_CloseFont,
-     * and clears the font map. It also destroys the cached score texture if it exists.
+     * and clears the font map. It also destroys the glyph atlases and the cached score texture if it exists.
      * This function should be called when the application is exiting to free up resources.
      */
     void CleanUp();
@@ -82,6 +129,8 @@ private:
     int lastScore = -1;
     SDL_Texture* cachedScoreTexture = nullptr;
     std::map<std::string, TTF_Font*> fonts;
+    std::map<std::string, std::unique_ptr<GlyphAtlas>> glyphs;
+    SpriteBatch textBatch;
 };
 
 #endif // FONTMANAGER_H
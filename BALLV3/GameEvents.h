@@ -0,0 +1,92 @@
+#pragma once
+#ifndef GameEvents_h
+#define GameEvents_h
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+* what happened during one simulation tick, appended by the simulation and drained afterwards
+*
+* the physics only records events: scoring, sounds and the HUD read them once the tick is over,
+* so nothing in the collision loop reaches out to the player or the mixer
+* the buffer is sized once, pushing never allocates: past its capacity an event is only counted,
+* the counts are exact however many events a tick raised
+*/
+
+enum GameEventType : uint8_t
+{
+    //a projectile touched a planet or a wall, index is the entity
+    EVENT_HIT = 0,
+    //a planet took its last hit, index is the entity
+    EVENT_KILL,
+    //a projectile left the playfield, index is the projectile
+    EVENT_PROJECTILE_LOST,
+    //one more projectile per burst
+    EVENT_LEVEL_UP,
+    //a planet got past the top
+    EVENT_GAME_OVER
+};
+
+const int gameEventTypeCount = 5;
+
+struct GameEvent
+{
+    GameEventType type;
+    uint32_t index;
+};
+
+class GameEventBuffer
+{
+public:
+    //events kept with their index per tick, more than a dense burst raises
+    static const size_t defaultCapacity = 1024;
+
+    explicit GameEventBuffer(size_t capacity = defaultCapacity)
+        : events(capacity)
+    {
+    }
+
+    void push(GameEventType type, uint32_t index = 0)
+    {
+        counts[type]++;
+        if (stored < events.size()) {
+            events[stored++] = { type, index };
+        }
+    }
+
+    //forgets the events, the simulation calls it at the start of every tick
+    void clear()
+    {
+        stored = 0;
+        for (uint32_t& count : counts) {
+            count = 0;
+        }
+    }
+
+    //how many events of a type were pushed, stored or not
+    uint32_t count(GameEventType type) const { return counts[type]; }
+
+    //every event pushed, stored or not
+    size_t getTotal() const
+    {
+        size_t total = 0;
+        for (uint32_t count : counts) {
+            total += count;
+        }
+        return total;
+    }
+
+    //the stored events, in the order they were pushed
+    size_t size() const { return stored; }
+    const GameEvent& operator[](size_t i) const { return events[i]; }
+    const GameEvent* begin() const { return events.data(); }
+    const GameEvent* end() const { return events.data() + stored; }
+
+private:
+    std::vector<GameEvent> events;
+    size_t stored = 0;
+    uint32_t counts[gameEventTypeCount] = {};
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    //wide enough for the 95 glyphs of a 24 px font in a few rows
+    const int pageWidth = 512;
+    //clear pixels around every glyph, so filtering never picks up a neighbour
+    const int padding = 1;
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    releaseTexture();
+    SDL_FreeSurface(page);
+}
+
+bool GlyphAtlas::build(TTF_Font* font)
+{
+    releaseTexture();
+    SDL_FreeSurface(page);
+    page = nullptr;
+    for (Glyph& glyph : glyphs) {
+        glyph = Glyph();
+    }
+    kerning.clear();
+    if (!font) {
+        return false;
+    }
+
+    lineSkip = TTF_FontLineSkip(font);
+    height = TTF_FontHeight(font);
+
+    //rasterize first, the page is sized once every glyph's width is known
+    const SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* rendered[glyphCount] = {};
+    bool built = true;
+    int rowX = 0, rows = 1;
+    for (int i = 0; i < glyphCount; ++i) {
+        const Uint32 c = static_cast<Uint32>(firstChar + i);
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics32(font, c, &minX, &maxX, &minY, &maxY, &advance) != 0) {
+            continue;
+        }
+        glyphs[i].advance = advance;
+        //a space has nothing to draw
+        if (maxX <= minX) {
+            continue;
+        }
+
+        SDL_Surface* surface = TTF_RenderGlyph32_Blended(font, c, white);
+        if (!surface) {
+            std::cout << "text rendering not good TTF_Error: " << TTF_GetError() << std::endl;
+            built = false;
+            continue;
+        }
+        rendered[i] = surface;
+        //the glyph's box starts at the pen, further left when it overhangs
+        glyphs[i].offsetX = std::min(minX, 0);
+
+        if (rowX + surface->w + 2 * padding > pageWidth) {
+            rowX = 0;
+            rows++;
+        }
+        glyphs[i].region = { rowX + padding, (rows - 1) * (height + 2 * padding) + padding, surface->w, std::min(surface->h, height) };
+        rowX += surface->w + 2 * padding;
+    }
+
+    page = SDL_CreateRGBSurfaceWithFormat(0, pageWidth, rows * (height + 2 * padding), 32, SDL_PIXELFORMAT_RGBA32);
+    if (!page) {
+        std::cout << "Could not create glyph page: " << SDL_GetError() << std::endl;
+        built = false;
+    }
+    else {
+        SDL_FillRect(page, nullptr, SDL_MapRGBA(page->format, 0, 0, 0, 0));
+    }
+    for (int i = 0; i < glyphCount; ++i) {
+        if (!rendered[i]) {
+            continue;
+        }
+        if (page) {
+            const Rect& region = glyphs[i].region;
+            SDL_Rect src = { 0, 0, region.w, region.h };
+            SDL_Rect dst = { region.x, region.y, region.w, region.h };
+            //copy alpha as it is instead of blending onto the clear page
+            SDL_SetSurfaceBlendMode(rendered[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(rendered[i], &src, page, &dst);
+        }
+        SDL_FreeSurface(rendered[i]);
+    }
+
+    if (TTF_GetFontKerning(font)) {
+        kerning.assign(glyphCount * glyphCount, 0);
+        bool kerned = false;
+        for (int a = 0; a < glyphCount; ++a) {
+            for (int b = 0; b < glyphCount; ++b) {
+                const int amount = TTF_GetFontKerningSizeGlyphs32(font, firstChar + a, firstChar + b);
+                kerning[a * glyphCount + b] = static_cast<signed char>(amount);
+                kerned = kerned || amount != 0;
+            }
+        }
+        //most pixel fonts kern nothing, skip the lookups
+        if (!kerned) {
+            kerning.clear();
+        }
+    }
+    return built && page;
+}
+
+SDL_Texture* GlyphAtlas::getTexture(SDL_Renderer* renderer)
+{
+    if (texture && textureRenderer == renderer) {
+        return texture;
+    }
+    releaseTexture();
+    if (!page || !renderer) {
+        return nullptr;
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, page);
+    if (!texture) {
+        std::cout << "texture from rendered text not good SDL_Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    textureRenderer = renderer;
+    return texture;
+}
+
+void GlyphAtlas::releaseTexture()
+{
+    if (texture) {
+        SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+    textureRenderer = nullptr;
+}
+
+int GlyphAtlas::measure(const char* text) const
+{
+    int width = 0;
+    char previous = 0;
+    for (const char* c = text; *c && *c != '\n'; ++c) {
+        width += getKerning(previous, *c) + getGlyph(*c).advance;
+        previous = *c;
+    }
+    return width;
+}
+
+int GlyphAtlas::draw(SpriteBatch& batch, SDL_Renderer* renderer, const char* text, SDL_Color color, int x, int y)
+{
+    SDL_Texture* glyphTexture = getTexture(renderer);
+    if (!glyphTexture) {
+        return 0;
+    }
+    layout(text, x, y, [&](const Rect& src, const Rect& dst) {
+        const SDL_FRect to = { static_cast<float>(dst.x), static_cast<float>(dst.y),
+            static_cast<float>(dst.w), static_cast<float>(dst.h) };
+        batch.draw(glyphTexture, src, to, color);
+    });
+    return measure(text);
+}
@@ -0,0 +1,144 @@
+#pragma once
+#ifndef GlyphAtlas_h
+#define GlyphAtlas_h
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <vector>
+
+#include "SimTypes.h"
+#include "SpriteBatch.h"
+
+/*
+* every printable ASCII glyph of one font and size, rasterized once in white into a single texture
+*
+* a string is then laid out from the cached advances and kerning and drawn as one quad per glyph,
+* tinted through the vertex colour, so text costs no surface or texture per frame and a whole
+* screen of it on one atlas is one SpriteBatch call
+* the rasterized page is kept on the CPU side, the texture is uploaded for whichever renderer draws with it
+*/
+
+struct Glyph
+{
+    //the glyph's pixels in the page, empty for a space
+    Rect region = { 0, 0, 0, 0 };
+    //from the pen position to the region's left edge
+    int offsetX = 0;
+    //how far the pen moves after it
+    int advance = 0;
+};
+
+class GlyphAtlas
+{
+public:
+    //the characters rasterized, anything else is drawn as firstChar's advance
+    static const char firstChar = ' ';
+    static const char lastChar = '~';
+
+    GlyphAtlas() = default;
+    ~GlyphAtlas();
+
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    /**
+     * Rasterizes every glyph of a font into the page and caches their metrics.
+     *
+     * @param font The font, at the size the text is drawn at. Only used during the call.
+     *
+     * @return true if every glyph was rasterized, false otherwise.
+     */
+    bool build(TTF_Font* font);
+
+    /**
+     * The page as a texture for a renderer, uploaded the first time it is asked for with that renderer.
+     *
+     * @param renderer The renderer the text is drawn with.
+     *
+     * @return The texture, or nullptr if the atlas isn't built or the upload failed.
+     */
+    SDL_Texture* getTexture(SDL_Renderer* renderer);
+
+    //destroys the uploaded texture, call before destroying the renderer it was uploaded for
+    void releaseTexture();
+
+    const Glyph& getGlyph(char c) const
+    {
+        return glyphs[c >= firstChar && c <= lastChar ? c - firstChar : 0];
+    }
+
+    //pixels between two lines of text
+    int getLineSkip() const { return lineSkip; }
+    //height of a line's glyph boxes
+    int getHeight() const { return height; }
+
+    //width of a line of text, in pixels
+    int measure(const char* text) const;
+
+    /**
+     * Lays a line of text out from the cached metrics.
+     *
+     * @param text The text, a '\n' starts a new line.
+     * @param x The x-coordinate of the first glyph's pen position.
+     * @param y The y-coordinate of the top of the first line.
+     * @param emit Called with (const Rect& src, const Rect& dst) for every glyph that has pixels.
+     */
+    template <typename Emit>
+    void layout(const char* text, int x, int y, Emit&& emit) const
+    {
+        int penX = x;
+        char previous = 0;
+        for (const char* c = text; *c; ++c) {
+            if (*c == '\n') {
+                penX = x;
+                y += lineSkip;
+                previous = 0;
+                continue;
+            }
+            penX += getKerning(previous, *c);
+            const Glyph& glyph = getGlyph(*c);
+            if (glyph.region.w > 0) {
+                emit(glyph.region, Rect{ penX + glyph.offsetX, y, glyph.region.w, glyph.region.h });
+            }
+            penX += glyph.advance;
+            previous = *c;
+        }
+    }
+
+    /**
+     * Queues a line of text on a batch. Nothing is drawn before the batch is flushed.
+     *
+     * @param batch The batch to queue the glyphs on, with the renderer the texture is uploaded for.
+     * @param renderer The renderer the batch draws with.
+     * @param text The text, a '\n' starts a new line.
+     * @param color The colour the white glyphs are tinted with.
+     * @param x The x-coordinate of the text's top left corner.
+     * @param y The y-coordinate of the text's top left corner.
+     *
+     * @return The width of the text's first line, in pixels.
+     */
+    int draw(SpriteBatch& batch, SDL_Renderer* renderer, const char* text, SDL_Color color, int x, int y);
+
+private:
+    //kerning between two characters, 0 if the font has none
+    int getKerning(char previous, char c) const
+    {
+        if (kerning.empty() || previous < firstChar || previous > lastChar || c < firstChar || c > lastChar) {
+            return 0;
+        }
+        return kerning[(previous - firstChar) * glyphCount + (c - firstChar)];
+    }
+
+    static const int glyphCount = lastChar - firstChar + 1;
+
+    Glyph glyphs[glyphCount];
+    //glyphCount x glyphCount, left empty when no pair is kerned
+    std::vector<signed char> kerning;
+    int lineSkip = 0;
+    int height = 0;
+
+    SDL_Surface* page = nullptr;
+    SDL_Texture* texture = nullptr;
+    SDL_Renderer* textureRenderer = nullptr;
+};
+
+#endif
@@ -10,12 +10,25 @@
 #include <cstring>
 #include <stdio.h>
 #include <ctime>
+#include <chrono>
+#include <memory>
 
 #include "FontManager.h"
 #include "Player.h"
 #include "Collisions.h"
 #include "Entities.h"
+#include "EntityRegistry.h"
 #include "RenderWindow.h"
+#include "BroadPhase.h"
+#include "FixedTimestep.h"
+#include "World.h"
+#include "Simulation.h"
+#include "Replay.h"
+#include "Scenario.h"
+#include "Profiler.h"
+#include "PerfHud.h"
+#include "AssetArchive.h"
+#include "AssetLoader.h"
 #include "Audio.h"
 #include "PowerUp.h"
 
@@ -27,6 +40,12 @@ class Entity;
 */
 void showDeathScreen(SDL_Renderer* renderer, const std::string& fontID, SDL_Event& event, bool& gameRunning, Player& player, Audio& audio);
 
+/*
+* splash screen with a progress bar while the assets load, one frame per call
+* return void
+*/
+void showLoadingScreen(RenderWindow& window, GlyphAtlas* glyphs, const AssetLoader& loader);
+
 int main(int argc, char* args[]) {
 
     //DATA ABSTRACTION // 
@@ -51,160 +70,408 @@ int main(int argc, char* args[]) {
         std::cerr << "Failed to initialize audio: " << Mix_GetError() << std::endl;
     }
 
-    // Load audio files
-    if (!audio.loadMp3("hitSound.wav", "deathSound.wav", "levelUpSound.wav", "backgroundMs.wav", "gameOver.wav")) {
-        std::cerr << "Failed to load audio files: " << Mix_GetError() << std::endl;
+    const int maxTicksPerFrame = 5;
+
+    //--seed N replays the same planet layout, otherwise every game is different
+    //--record FILE saves the game as a replay, --replay FILE watches one at normal speed
+    //--trace FILE is where a profiling build writes its Chrome trace, on F9 and at exit
+    //--software draws without the GPU and only presents what changed
+    //--max-fps N caps the frame rate when the renderer has no vsync, 144 by default, 0 draws as fast as it can
+    //--record-render FILE saves every frame's draws, for replaying the render path in BALLV3Bench
+    //F3 shows the performance overlay, F4 starts and stops logging it to --perf-log FILE
+    //--assets FILE is the archive made by ballpack that assets are loaded from first, assets.pak by default
+    //--scenario FILE plays the first stress scene of a scenario file on screen, --scenario-name NAME picks another
+    //--soft-mixer plays the sound effects through SoftMixer, 256-sample buffers instead of SDL_mixer's 2048
+    uint64_t seed = static_cast<uint64_t>(time(0));
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* scenarioPath = nullptr;
+    const char* tracePath = "trace.json";
+    const char* perfLogPath = "perf.csv";
+    const char* renderRecordPath = nullptr;
+    const char* archivePath = "assets.pak";
+    bool software = false;
+    bool softMixer = false;
+    int maxFramesPerSecond = 144;
+    std::string scenarioName;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(args[i], "--software") == 0) {
+            software = true;
+        }
+        if (strcmp(args[i], "--soft-mixer") == 0) {
+            softMixer = true;
+        }
+        if (i + 1 >= argc) {
+            break;
+        }
+        if (strcmp(args[i], "--seed") == 0) {
+            seed = strtoull(args[i + 1], nullptr, 10);
+        }
+        else if (strcmp(args[i], "--record") == 0) {
+            recordPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--replay") == 0) {
+            replayPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--scenario") == 0) {
+            scenarioPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--scenario-name") == 0) {
+            scenarioName = args[i + 1];
+        }
+        else if (strcmp(args[i], "--trace") == 0) {
+            tracePath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--perf-log") == 0) {
+            perfLogPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--record-render") == 0) {
+            renderRecordPath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--assets") == 0) {
+            archivePath = args[i + 1];
+        }
+        else if (strcmp(args[i], "--max-fps") == 0) {
+            maxFramesPerSecond = atoi(args[i + 1]);
+        }
     }
 
-    //max fps
-    const int maxFPS = 32;
-    const int frame_time = 1000 / maxFPS;
-    Uint32 framestart;
-    int frame;
+    ReplayPlayer replay;
+    bool replaying = replayPath && replay.load(replayPath);
+    if (replaying) {
+        seed = replay.getSeed();
+    }
+    std::cout << "seed: " << seed << std::endl;
 
-    const float gravityStrength = 6.0f;
+    //before the sounds are set, so they go straight to the soft mixer
+    if (softMixer && !audio.startSoftMixer()) {
+        std::cout << "soft mixer unavailable, sound effects play through SDL_mixer" << std::endl;
+    }
 
-    srand(static_cast<unsigned int>(time(0)));
     int windowHeight = 840;
     int windowWidth = 620;
 
-    RenderWindow window("window", windowWidth, windowHeight);
-
-    SDL_Texture* blueTexture = window.loadTexture("player.png");
-    SDL_Texture* projectileTexture = window.loadTexture("bullet2.png");
-    SDL_Texture* backgroundTexture = window.loadTexture("background2.png");
-
-    std::vector<Entity> entities;
-    std::vector<Entity> projectile;
+    RenderWindow window("window", windowWidth, windowHeight, software);
+    RenderRecording renderRecording;
+    if (renderRecordPath) {
+        window.setRecording(&renderRecording);
+    }
 
-    SDL_Surface* mouse = IMG_Load("crosshair.png");
-    SDL_Cursor* cursor = SDL_CreateColorCursor(mouse, 0, 0);
-    SDL_FreeSurface(mouse);
+    //baked pixels and samples, mapped rather than read, anything missing from it is loaded from its own file
+    if (AssetArchive::Instance().open(archivePath)) {
+        std::cout << "assets from " << archivePath << std::endl;
+    }
 
+    //the splash screen writes with the HUD font, fonts are small enough to open right away
+    FontManager::Instance().LoadFont("default", "HomeVideoBold-R90Dv.ttf", 24);
+    FontManager::Instance().LoadFont("hud", "HomeVideo-BLG6G.ttf", 14);
+    //rasterized once here, every frame's text is laid out from them
+    GlyphAtlas* scoreGlyphs = FontManager::Instance().GetGlyphs("default");
+    GlyphAtlas* hudGlyphs = FontManager::Instance().GetGlyphs("hud");
+
+    //images and sounds are decoded on worker threads behind a splash screen, only their uploads run here
+    struct AtlasImage
+    {
+        TextureId id;
+        const char* path;
+        int packedSize;
+    };
+    const AtlasImage atlasImages[] = {
+        //the player image is 1024 px but always drawn at 64, it is packed into the atlas at that size
+        { TEXTURE_PLAYER, "player.png", 64 },
+        { TEXTURE_PROJECTILE, "bullet2.png", 0 },
+        { TEXTURE_WALL, "wall.png", 0 },
+        { TEXTURE_PLANET1, "planet1.png", 0 },
+        { TEXTURE_PLANET2, "planet2.png", 0 },
+        { TEXTURE_PLANET3, "planet3.png", 0 },
+        { TEXTURE_PLANET4, "planet4.png", 0 },
+        { TEXTURE_PLANET5, "planet5.png", 0 },
+    };
+    const int atlasImageCount = sizeof(atlasImages) / sizeof(atlasImages[0]);
+    const char* soundPaths[] = { "hitSound.wav", "deathSound.wav", "levelUpSound.wav", "gameOver.wav" };
+
+    AssetLoader loader;
+    //atlas images first, so their handles are their index in atlasImages
+    for (const AtlasImage& image : atlasImages) {
+        loader.addImage(image.path, image.packedSize, image.packedSize);
+    }
+    const int backgroundImage = loader.addImage("background2.png");
+    const int cursorImage = loader.addImage("crosshair.png");
+    const int firstSound = loader.addSound(soundPaths[0]);
+    for (int i = 1; i < 4; ++i) {
+        loader.addSound(soundPaths[i]);
+    }
 
-    Player player(300, 300, blueTexture, windowWidth, windowHeight);
+    SDL_Texture* backgroundTexture = nullptr;
+    SDL_Surface* mouse = nullptr;
+    Mix_Chunk* sounds[4] = {};
+    bool quitWhileLoading = false;
+    loader.start();
+    while (!loader.isDone() && !quitWhileLoading) {
+        SDL_Event loadingEvent;
+        while (SDL_PollEvent(&loadingEvent)) {
+            quitWhileLoading = quitWhileLoading || loadingEvent.type == SDL_QUIT;
+        }
 
-    window.addWalls(entities);
+        //a few milliseconds of uploads a frame keep the splash responsive
+        loader.uploadDecoded([&](LoadedAsset& asset) {
+            if (asset.kind == ASSET_SOUND) {
+                sounds[asset.handle - firstSound] = asset.sound;
+            }
+            else if (asset.handle == backgroundImage) {
+                backgroundTexture = window.createTexture(asset.image);
+            }
+            else if (asset.handle == cursorImage) {
+                mouse = asset.image;
+            }
+            else if (asset.handle < atlasImageCount) {
+                window.loadTexture(atlasImages[asset.handle].id, asset.image);
+            }
+        }, 8.0);
 
-    FontManager::Instance().LoadFont("default", "HomeVideoBold-R90Dv.ttf", 24);
+        showLoadingScreen(window, hudGlyphs, loader);
+        SDL_Delay(4);
+    }
+    //a quit on the splash leaves workers decoding, they must be done before anything below tears SDL down
+    loader.cancel();
 
+    const std::chrono::steady_clock::time_point atlasStart = std::chrono::steady_clock::now();
+    window.buildAtlas();
+    const double atlasMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - atlasStart).count();
+    if (!audio.setSounds(sounds[0], sounds[1], sounds[2], sounds[3])) {
+        std::cerr << "Failed to load audio files: " << Mix_GetError() << std::endl;
+    }
+    audio.loadMusic("backgroundMs.wav");
+    if (loader.isDone()) {
+        loader.report(std::cout);
+        std::cout << "atlas packed and uploaded in " << atlasMs << " ms" << std::endl;
+    }
 
-    //textures for entities
-    SDL_Texture* planet1 = window.loadTexture("planet1.png");
-    SDL_Texture* planet2 = window.loadTexture("planet2.png");
-    SDL_Texture* planet3 = window.loadTexture("planet3.png");
-    SDL_Texture* planet4 = window.loadTexture("planet4.png");
-    SDL_Texture* planet5 = window.loadTexture("planet5.png");
+    //a scenario brings its own world and inputs, the mouse and SPACE are ignored while it plays
+    std::unique_ptr<ScenarioRun> scenarioRun;
+    std::vector<Scenario> scenarios;
+    if (scenarioPath && Scenario::loadFile(scenarioPath, scenarios)) {
+        for (const Scenario& scenario : scenarios) {
+            if (!scenarioRun && (scenarioName.empty() || scenario.name == scenarioName)) {
+                ScenarioRun::resetPeakMemory();
+                scenarioRun.reset(new ScenarioRun(scenario));
+            }
+        }
+        if (!scenarioRun) {
+            std::cout << "no scenario named " << scenarioName << " in " << scenarioPath << std::endl;
+        }
+    }
+    const bool scripted = replaying || scenarioRun;
 
-    SDL_Texture* textures[] = { planet1, planet2, planet3, planet4, planet5 };
+    //bodies, player and broadphase, everything the simulation touches
+    World gameWorld(windowWidth, windowHeight, seed);
+    World& world = scenarioRun ? scenarioRun->getWorld() : gameWorld;
+    ReplayRecorder recorder(world);
 
-    static int spawnCounter = 0;
+    //the crosshair may not have arrived if the splash was quit
+    SDL_Cursor* cursor = mouse ? SDL_CreateColorCursor(mouse, 0, 0) : nullptr;
+    SDL_FreeSurface(mouse);
 
-    bool gameRunning = true;
+    bool gameRunning = !quitWhileLoading;
     bool gameOver = false;
     bool restartGame = false;
     SDL_Event event;
-    bool isOutOfBounds = false;
-    static bool musicStarted = false;
+    bool musicStarted = false;
+
+    PerfHud perfHud;
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point lastFrame = Clock::now();
 
 
     //PROCESS//
     //GAME LOOP
+    FixedTimestep timestep(Simulation::ticksPerSecond, maxTicksPerFrame);
+    //one frame per tick of this one, when vsync isn't there to pace the loop
+    const bool capFrames = !window.isVsynced() && maxFramesPerSecond > 0;
+    FixedTimestep framePacer(capFrames ? maxFramesPerSecond : 1, 1);
+    Profiler::setThreadName("main");
     while (gameRunning) {
-        //max fps
-        framestart = SDL_GetTicks();
-        frame = SDL_GetTicks() - framestart;
-        if (frame < frame_time) {
-            SDL_Delay(frame_time - frame);
-        }
+        //how many ticks of real time passed since the last frame, capped so a stall can't snowball
+        //most frames run none, they still poll input and draw, moved along by the time since the last tick
+        int ticksDue = timestep.advance();
+
+        PROFILE_ZONE("frame");
+        const Clock::time_point frameStart = Clock::now();
+        const double frameMs = std::chrono::duration<double, std::milli>(frameStart - lastFrame).count();
+        lastFrame = frameStart;
 
         //set cursor texture
-        SDL_SetCursor(cursor);
+        if (cursor) {
+            SDL_SetCursor(cursor);
+        }
 
         if (!musicStarted) {
             audio.playBg();
             musicStarted = true;
         }
 
-        //Render window
-        SDL_RenderClear(window.getRenderer());
-        SDL_RenderCopy(window.getRenderer(), backgroundTexture, nullptr, nullptr);
-
-
-        //Set of static functions that make up the gameloop
-        Player::outOfBounds(projectile, windowWidth, windowHeight, &isOutOfBounds, audio);
-        
-        //entity gets one of the 5 available textures in the textures array
-        //selection loops after every 5 spawns.
-        SDL_Texture* chosenTexture = textures[spawnCounter % 5];
-        Entity::Spawn(event, entities, chosenTexture, windowWidth, windowHeight, &isOutOfBounds);
-        spawnCounter++;
-
-        //constantly check for collision betweeen entities and projectiles
-        Collisions::checkCollisions(entities, projectile, player, audio, audio);
-
-        //apply gravity on the projectile
-        Collisions::applyGravity(projectile, gravityStrength);
-
-        //Score display
-        SDL_Color white = { 255, 255, 255 };
-        FontManager::Instance().RenderScore("default", white, 60, 20, window.getRenderer(), player);
-
+        //aim follows the mouse, unless a replay or a scenario is doing the aiming
+        int mouseX, mouseY;
+        SDL_GetMouseState(&mouseX, &mouseY);
+        if (!scripted) {
+            world.player.aimAt(mouseX, mouseY);
+        }
 
-        //constantly render projectiles, entities, update their position, and allowing shoot operation
+        //allowing shoot operation before the projectiles are moved
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 gameRunning = false;
             }
-            player.shoot(event, projectile, projectileTexture, 32);
-        }
-
-        for (auto& proj : projectile) {
-            proj.updatePosition();
-        }
-
-        for (auto& proj : projectile) {
-            window.render(proj);
-        }
-        for (auto& entity : entities) {
-            window.render(entity);
+            if (Profiler::isEnabled() && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F9
+                && Profiler::writeChromeTrace(tracePath)) {
+                std::cout << "trace written to " << tracePath << std::endl;
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) {
+                perfHud.toggle();
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F4) {
+                if (perfHud.isLogging()) {
+                    perfHud.stopLog();
+                    std::cout << "perf log written to " << perfLogPath << std::endl;
+                }
+                else {
+                    perfHud.startLog(perfLogPath);
+                }
+            }
+            if (!scripted && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE) {
+                if (Simulation::fire(world)) {
+                    recorder.recordFire(world);
+                }
+            }
         }
 
-        //game over 
-        for (auto& entity : entities) {
-            if (entity.getY() <= -48 && !entity.getisProjectile() && !entity.getIsWall()) {
+        //spawn, bursts, gravity, collisions and the game-over check, once per simulation tick
+        PerfCounters counters;
+        for (int tick = 0; tick < ticksDue && gameRunning; ++tick) {
+            if (scenarioRun) {
+                //scripted inputs and a timed step, the scenario decides when it is over
+                gameRunning = scenarioRun->tick();
+                audio.playEvents(world.events);
+                counters.events += world.events.getTotal();
+                counters.pairsTested += world.broadphase.getPairsTested();
+                continue;
+            }
+            if (replaying) {
+                replay.applyInputs(world);
+            }
+            if (!Simulation::step(world)) {
                 gameRunning = false; // Stop the game loop
-                break;
+            }
+            //sound and the HUD drain the events of the tick, the score was already counted by the step
+            audio.playEvents(world.events);
+            counters.events += world.events.getTotal();
+            counters.pairsTested += world.broadphase.getPairsTested();
+            recorder.recordStep(world);
+
+            if (replaying && !replay.verifyStep(world)) {
+                std::cout << "replay desynced at tick " << world.tickCount << std::endl;
+                replaying = false;
+                gameRunning = false;
+            }
+            if (replaying && replay.isFinished(world)) {
+                gameRunning = false;
             }
         }
-        player.render(window.getRenderer());
+        //the sounds of every tick above, one voice per sound however many times it was triggered
+        audio.update();
 
+        //Render window
+        {
+            PROFILE_ZONE("render");
+            window.clear();
+            //background, walls and resting planets come from a cached layer, redrawn when a wave shifts or a planet dies
+            window.renderStatic(backgroundTexture, world.entities);
+
+            //Score display
+            SDL_Color white = { 255, 255, 255, 255 };
+            if (scoreGlyphs) {
+                char scoreText[32];
+                snprintf(scoreText, sizeof(scoreText), "Score: %d", world.player.getScore());
+                window.renderText(*scoreGlyphs, scoreText, white, 60, 20);
+            }
 
+            //constantly render projectiles and the player, recorded by layer and drawn one texture per call at the flush
+            //projectiles are drawn as far along as the time banked towards the next tick
+            window.render(world.projectiles, static_cast<float>(timestep.getAlpha()));
+            window.render(world.player);
+            window.flush();
+
+            //drawn last and left out of the draw calls it reports
+            counters.entities = world.entities.size();
+            counters.projectiles = world.projectiles.size();
+            counters.drawCalls = window.getDrawCalls();
+            counters.voices = audio.getVoicesInUse();
+            perfHud.addFrame(frameMs, counters);
+            window.addDirtyRect(perfHud.render(window.getRenderer(), hudGlyphs, 8, windowHeight - 140));
+        }
 
-        window.display();
+        //vsync and the frame cap wait here, outside the render zone
+        {
+            PROFILE_ZONE("present");
+            window.display();
+        }
+        if (capFrames) {
+            PROFILE_ZONE("frame pacing");
+            framePacer.waitForNextTick();
+            framePacer.advance();
+        }
+    }
 
-        //close the game window
-        if (!gameRunning) {
-            window.cleanUp();
-            SDL_DestroyRenderer(window.getRenderer());
-            SDL_DestroyWindow(window.getWindow());
-            SDL_Window* gameOverWindow = SDL_CreateWindow(
-                "Game Over",
-                SDL_WINDOWPOS_CENTERED,
-                SDL_WINDOWPOS_CENTERED,
-                620, 840,
-                SDL_WINDOW_SHOWN
-            );
-            SDL_Renderer* gameOverRenderer = SDL_CreateRenderer(gameOverWindow, -1, SDL_RENDERER_ACCELERATED);
+    //close the game window, the death screen waits for Q outside the frame zone
+    if (!quitWhileLoading) {
+        PROFILE_ZONE("death screen");
+        FontManager::Instance().ReleaseTextures();
+        window.cleanUp();
+        SDL_DestroyRenderer(window.getRenderer());
+        SDL_DestroyWindow(window.getWindow());
+        SDL_Window* gameOverWindow = SDL_CreateWindow(
+            "Game Over",
+            SDL_WINDOWPOS_CENTERED,
+            SDL_WINDOWPOS_CENTERED,
+            620, 840,
+            SDL_WINDOW_SHOWN
+        );
+        SDL_Renderer* gameOverRenderer = SDL_CreateRenderer(gameOverWindow, -1, SDL_RENDERER_ACCELERATED);
+
+        showDeathScreen(gameOverRenderer, "default", event, gameRunning, world.player, audio);
+
+        FontManager::Instance().ReleaseTextures();
+        SDL_DestroyRenderer(gameOverRenderer);
+        SDL_DestroyWindow(gameOverWindow);
+    }
 
-            showDeathScreen(gameOverRenderer, "default", event, gameRunning, player, audio);
+    if (scenarioRun) {
+        const ScenarioResult result = scenarioRun->getResult();
+        std::cout << "scenario " << result.name << ": " << result.ticks << " ticks, p50 " << result.p50Ms
+            << " ms, p95 " << result.p95Ms << " ms, p99 " << result.p99Ms << " ms, max " << result.maxMs
+            << " ms, peak " << result.peakMemoryMb << " MB" << std::endl;
+        for (const std::string& line : result.overBudget) {
+            std::cout << "  OVER BUDGET: " << line << std::endl;
+        }
+    }
+    else if (recordPath && recorder.save(recordPath)) {
+        std::cout << "replay saved to " << recordPath << std::endl;
+    }
 
-            SDL_DestroyRenderer(gameOverRenderer);
-            SDL_DestroyWindow(gameOverWindow);
+    if (renderRecordPath && renderRecording.save(renderRecordPath)) {
+        std::cout << renderRecording.getFrameCount() << " rendered frames saved to " << renderRecordPath << std::endl;
+    }
 
-            break;
-        }
+    if (perfHud.isLogging()) {
+        perfHud.stopLog();
+        std::cout << "perf log written to " << perfLogPath << std::endl;
+    }
 
+    if (Profiler::isEnabled() && Profiler::writeChromeTrace(tracePath)) {
+        std::cout << "trace written to " << tracePath << std::endl;
+    }
+    if (audio.getSoftMixer()) {
+        audio.getSoftMixer()->report(std::cout);
     }
 
     //Cleanup
@@ -212,6 +479,9 @@ int main(int argc, char* args[]) {
     FontManager::Instance().CleanUp();
     audio.cleanup();
     window.cleanUp();
+    //only once nothing loaded from the archive is left: the loader's workers were joined after the splash,
+    //the surfaces and chunks they decoded were uploaded or freed there, and the textures and sounds just above
+    AssetArchive::Instance().close();
     TTF_Quit();
     IMG_Quit();
     SDL_Quit();
@@ -220,7 +490,9 @@ int main(int argc, char* args[]) {
 }
 
 void showDeathScreen(SDL_Renderer* renderer, const std::string& fontID, SDL_Event& event, bool& gameRunning, Player& player, Audio& audio) {
-    SDL_Texture* backgroundTexture = IMG_LoadTexture(renderer, "background2.png");
+    SDL_Surface* packedBackground = AssetArchive::Instance().loadImage("background2.png");
+    SDL_Texture* backgroundTexture = packedBackground ? SDL_CreateTextureFromSurface(renderer, packedBackground) : IMG_LoadTexture(renderer, "background2.png");
+    SDL_FreeSurface(packedBackground);
     if (!backgroundTexture) {
         std::cerr << "Failed to load background texture: " << SDL_GetError() << std::endl;
         return;
@@ -242,6 +514,7 @@ void showDeathScreen(SDL_Renderer* renderer, const std::string& fontID, SDL_Even
     SDL_DestroyTexture(backgroundTexture);
 
     audio.playGameOver();
+    audio.update();
     
     while (true) {
         while (SDL_PollEvent(&event)) {
@@ -252,4 +525,29 @@ void showDeathScreen(SDL_Renderer* renderer, const std::string& fontID, SDL_Even
             }
         }
     }
-}
\ No newline at end of file
+}
+
+void showLoadingScreen(RenderWindow& window, GlyphAtlas* glyphs, const AssetLoader& loader) {
+    SDL_Renderer* renderer = window.getRenderer();
+    int width = 0, height = 0;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    // A bar across the middle of the window
+    const SDL_Rect bar = { width / 8, height / 2 - 8, width * 3 / 4, 16 };
+    const SDL_Rect done = { bar.x + 2, bar.y + 2, static_cast<int>((bar.w - 4) * loader.getProgress()), bar.h - 4 };
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &bar);
+    SDL_RenderFillRect(renderer, &done);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+
+    if (glyphs) {
+        char text[48];
+        snprintf(text, sizeof(text), "Loading %zu / %zu", loader.getUploadedCount(), loader.getAssetCount());
+        SDL_Color white = { 255, 255, 255, 255 };
+        window.renderText(*glyphs, text, white, bar.x, bar.y - glyphs->getLineSkip() - 4);
+    }
+    window.display();
+}
@@ -0,0 +1,149 @@
+#include "PerfHud.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    //how often the text lines are rebuilt, in milliseconds
+    const Uint32 refreshMs = 250;
+    //the graph's full height, two frames of a 60 Hz display
+    const float graphMaxMs = 1000.0f / 30.0f;
+    const float budgetMs = 1000.0f / 60.0f;
+    const int graphHeight = 60;
+    const int padding = 4;
+}
+
+PerfHud::PerfHud(size_t frameCount)
+    : frameMs(std::max<size_t>(frameCount, 1), 0.0f), sorted(frameMs.size()), bars(frameMs.size())
+{
+}
+
+void PerfHud::toggle()
+{
+    visible = !visible;
+    //the text is reformatted on the first frame drawn
+    lastRefresh = 0;
+}
+
+bool PerfHud::isVisible() const
+{
+    return visible;
+}
+
+bool PerfHud::startLog(const std::string& path)
+{
+    log.close();
+    log.clear();
+    log.open(path, std::ios::trunc);
+    if (!log) {
+        std::cerr << "Could not open perf log " << path << std::endl;
+        return false;
+    }
+    log << "frame,ms,entities,projectiles,pairs,draw_calls,voices,events\n";
+    return true;
+}
+
+void PerfHud::stopLog()
+{
+    log.close();
+}
+
+bool PerfHud::isLogging() const
+{
+    return log.is_open();
+}
+
+void PerfHud::addFrame(double ms, const PerfCounters& counters)
+{
+    frameMs[next] = static_cast<float>(ms);
+    next = (next + 1) % frameMs.size();
+    filled = std::min(filled + 1, frameMs.size());
+    latest = counters;
+    frameNumber++;
+
+    if (log.is_open()) {
+        char line[160];
+        snprintf(line, sizeof(line), "%llu,%.3f,%zu,%zu,%zu,%zu,%d,%zu\n", static_cast<unsigned long long>(frameNumber),
+            ms, counters.entities, counters.projectiles, counters.pairsTested, counters.drawCalls, counters.voices, counters.events);
+        log << line;
+    }
+}
+
+double PerfHud::getPercentile(double fraction) const
+{
+    if (filled == 0) {
+        return 0.0;
+    }
+
+    //the ring only holds valid frames at the front until it has wrapped once
+    std::copy(frameMs.begin(), frameMs.begin() + filled, sorted.begin());
+    size_t rank = static_cast<size_t>(std::ceil(fraction * filled));
+    rank = std::min(std::max<size_t>(rank, 1), filled) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + filled);
+    return sorted[rank];
+}
+
+void PerfHud::refreshText()
+{
+    snprintf(lineText[0], sizeof(lineText[0]), "frame p50 %.1f ms  p99 %.1f ms", getPercentile(0.50), getPercentile(0.99));
+    snprintf(lineText[1], sizeof(lineText[1]), "planets %zu  projectiles %zu  events %zu", latest.entities, latest.projectiles, latest.events);
+    snprintf(lineText[2], sizeof(lineText[2]), "pairs %zu  draws %zu  voices %d", latest.pairsTested, latest.drawCalls, latest.voices);
+}
+
+SDL_Rect PerfHud::render(SDL_Renderer* renderer, GlyphAtlas* glyphs, int x, int y)
+{
+    if (!visible || !glyphs) {
+        return { 0, 0, 0, 0 };
+    }
+
+    const Uint32 now = SDL_GetTicks();
+    if (lastRefresh == 0 || now - lastRefresh >= refreshMs) {
+        refreshText();
+        lastRefresh = now == 0 ? 1 : now;
+    }
+
+    Uint8 red, green, blue, alpha;
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawColor(renderer, &red, &green, &blue, &alpha);
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+
+    const int lineSkip = glyphs->getLineSkip();
+    const int graphWidth = static_cast<int>(frameMs.size());
+    const int graphTop = y + padding + lineCount * lineSkip + padding;
+    SDL_Rect panel = { x, y, graphWidth + 2 * padding, graphTop + graphHeight + padding - y };
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &panel);
+
+    //every line from the one glyph texture, a single draw
+    const SDL_Color white = { 255, 255, 255, 255 };
+    textBatch.setRenderer(renderer);
+    for (int i = 0; i < lineCount; ++i) {
+        glyphs->draw(textBatch, renderer, lineText[i], white, x + padding, y + padding + i * lineSkip);
+    }
+    textBatch.flush();
+
+    //oldest frame on the left, one pixel column per frame
+    const int graphLeft = x + padding;
+    const int graphBottom = graphTop + graphHeight;
+    const size_t oldest = filled < frameMs.size() ? 0 : next;
+    for (size_t i = 0; i < filled; ++i) {
+        const float ms = std::min(frameMs[(oldest + i) % frameMs.size()], graphMaxMs);
+        const int height = std::max(1, static_cast<int>(ms / graphMaxMs * graphHeight));
+        bars[i] = { graphLeft + static_cast<int>(i), graphBottom - height, 1, height };
+    }
+    SDL_SetRenderDrawColor(renderer, 80, 220, 120, 255);
+    SDL_RenderFillRects(renderer, bars.data(), static_cast<int>(filled));
+
+    //the 60 Hz budget
+    const int budgetY = graphBottom - static_cast<int>(budgetMs / graphMaxMs * graphHeight);
+    SDL_SetRenderDrawColor(renderer, 230, 80, 80, 255);
+    SDL_RenderDrawLine(renderer, graphLeft, budgetY, graphLeft + graphWidth - 1, budgetY);
+
+    SDL_SetRenderDrawColor(renderer, red, green, blue, alpha);
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+    return panel;
+}
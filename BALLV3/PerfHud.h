@@ -0,0 +1,120 @@
+#pragma once
+#ifndef PerfHud_h
+#define PerfHud_h
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "GlyphAtlas.h"
+#include "SpriteBatch.h"
+
+/*
+* toggleable performance overlay: a rolling frame-time graph, p50/p99 over the frames in the graph,
+* and what the frame cost was spent on
+*
+* the graph is one SDL_RenderFillRects call and the text one batch from the font's glyph atlas,
+* reformatted a few times a second, so drawing the overlay barely moves the numbers it shows
+* draw calls the overlay makes itself are never counted
+*/
+
+//what one frame did, filled in by the game loop
+struct PerfCounters
+{
+    size_t entities = 0;
+    size_t projectiles = 0;
+    //candidate pairs the broadphase handed to the narrowphase, over every tick of the frame
+    size_t pairsTested = 0;
+    //render calls for the game itself, the overlay excluded
+    size_t drawCalls = 0;
+    int voices = 0;
+    //game events raised over every tick of the frame: hits, kills, lost projectiles
+    size_t events = 0;
+};
+
+class PerfHud
+{
+public:
+    /**
+     * Creates a hidden overlay.
+     *
+     * @param frameCount How many of the latest frames the graph and the percentiles cover.
+     */
+    explicit PerfHud(size_t frameCount = 240);
+
+    PerfHud(const PerfHud&) = delete;
+    PerfHud& operator=(const PerfHud&) = delete;
+
+    void toggle();
+    bool isVisible() const;
+
+    /**
+     * Starts writing one CSV line per frame: frame, ms, entities, projectiles, pairs, draw calls, voices, events.
+     *
+     * @param path The file to create or overwrite.
+     *
+     * @return true if the file could be opened, false otherwise.
+     */
+    bool startLog(const std::string& path);
+    void stopLog();
+    bool isLogging() const;
+
+    /**
+     * Adds a frame to the graph, and to the CSV log when one is open. Recorded even while hidden,
+     * so the overlay shows a full graph the moment it is toggled on.
+     *
+     * @param frameMs Time since the previous frame, in milliseconds.
+     * @param counters What the frame did.
+     */
+    void addFrame(double frameMs, const PerfCounters& counters);
+
+    /**
+     * Draws the overlay when it is visible. Leaves the draw color and blend mode as it found them.
+     *
+     * @param renderer The SDL_Renderer to draw on.
+     * @param glyphs The glyph atlas of the text lines' font, from FontManager::GetGlyphs.
+     * @param x The left edge of the overlay.
+     * @param y The top edge of the overlay.
+     *
+     * @return The region drawn over, empty while hidden.
+     */
+    SDL_Rect render(SDL_Renderer* renderer, GlyphAtlas* glyphs, int x, int y);
+
+    /**
+     * Nearest-rank percentile of the frame times in the graph.
+     *
+     * @param fraction 0.5 for the median, 0.99 for p99.
+     *
+     * @return The frame time in milliseconds, 0 before the first frame.
+     */
+    double getPercentile(double fraction) const;
+
+private:
+    void refreshText();
+
+    static const int lineCount = 3;
+
+    bool visible = false;
+
+    //ring of the latest frame times, next is where the following frame goes
+    std::vector<float> frameMs;
+    size_t next = 0;
+    size_t filled = 0;
+    uint64_t frameNumber = 0;
+    PerfCounters latest;
+
+    //scratch space, sized once, so percentiles never allocate
+    mutable std::vector<float> sorted;
+    std::vector<SDL_Rect> bars;
+
+    //text is reformatted on this period, in SDL ticks
+    Uint32 lastRefresh = 0;
+    char lineText[lineCount][96] = {};
+    SpriteBatch textBatch;
+
+    std::ofstream log;
+};
+
+#endif
@@ -1,5 +1,14 @@
 #include "Player.h"
-Player::Player(int width, int height, SDL_Texture* texture, int& windowWidth, int& windowHeight)
+
+#include <cmath>
+
+namespace
+{
+	const double pi = 3.14159265358979323846;
+	const double aimSteps = 65536.0;
+}
+
+Player::Player(int width, int height, int texture, int& windowWidth, int& windowHeight)
 	:texture(texture)
 {
 	rect = { 0, 0, 64, 64 };
@@ -7,31 +16,49 @@ Player::Player(int width, int height, SDL_Texture* texture, int& windowWidth, in
 	rect.y = 64;
 }
 
-void Player::aiming() const
+void Player::aimAt(int targetX, int targetY)
 {
-	int mouseX, mouseY;
-	SDL_GetMouseState(&mouseX, &mouseY);
-
-	int playerCenterX = rect.x + rect.w / 2;
+	int playerCenterX = rect.x + rect.w / 2 - 15; //centered shooting
 	int playerCenterY = rect.y + rect.h / 2;
 
-	double deltaX = mouseX - playerCenterX;
-	double deltaY = mouseY - playerCenterY;
-	double angle = atan2(deltaY, deltaX) * 180 / M_PI;
+	double deltaX = targetX - playerCenterX;
+	double deltaY = targetY - playerCenterY;
+	setAimAngle(atan2(deltaY, deltaX));
+}
+
+void Player::setAimAngle(double angle)
+{
+	//2^16 steps is about 0.1 px of spread at the bottom of the screen
+	long step = lround(angle / (2.0 * pi) * aimSteps);
+	aimStep = static_cast<uint16_t>(step & 0xFFFF);
+}
+
+double Player::getAimAngle() const
+{
+	return aimStep * (2.0 * pi / aimSteps);
+}
+
+void Player::setAimStep(uint16_t step)
+{
+	aimStep = step;
 }
 
-void Player::fireProjectile(std::vector<Entity>& projectile, SDL_Texture* projectileTexture, int velocity) const
+uint16_t Player::getAimStep() const
 {
-	int mouseX;
-	int mouseY;
-	SDL_GetMouseState(&mouseX, &mouseY);
+	return aimStep;
+}
+
+uint32_t Player::getShotsFired() const
+{
+	return shotsFired;
+}
 
+void Player::fireProjectile(EntityRegistry& projectile, int projectileTexture, int velocity) const
+{
 	int playerCenterX = rect.x + rect.w / 2 - 15; //centered shooting
 	int playerCenterY = rect.y + rect.h / 2;
 
-	double deltaX = mouseX - playerCenterX;
-	double deltaY = mouseY - playerCenterY;
-	double angle = atan2(deltaY, deltaX);
+	double angle = getAimAngle();
 
 	int projectileX = playerCenterX;
 	int projectileY = playerCenterY;
@@ -40,50 +67,54 @@ void Player::fireProjectile(std::vector<Entity>& projectile, SDL_Texture* projec
 	int velocityY = velocity * sin(angle);
 
 
-	projectile.emplace_back(projectileX, projectileY, projectileTexture, velocityX, velocityY, true);
+	projectile.add(Entity(projectileX, projectileY, projectileTexture, velocityX, velocityY, true));
 	//std::cout << projectile.size() << std::endl;
 
 }
 
 /*
 press space > shoot > wait 0.09 > shoot again until firedProjectile >= maxProjectile
-keep fireDelay low to hide inconsistency errors
-SDL_Delay() and SDL_Getticks() doesn't work
-delay makes everything shoot at once, i cant fix it (if can fix that then use delay cuz its consistent)
-SDL_Getticks is stupidly inconsistent unless change FPS (don't do that)
+the wait is counted in simulation ticks (see updateBurst), so a burst is spaced the same on every machine
 */
 
-void Player::shoot(SDL_Event& event, std::vector<Entity>& projectiles, SDL_Texture* projectileTexture, int velocity) const
+bool Player::shoot(EntityRegistry& projectiles, int projectileTexture, int velocity)
 {
-	static bool isFiring = false;
-	static int firedProjectiles = 0;
-	static clock_t lastFireTime = 0;
+	if (isFiring)
+	{
+		return false;
+	}
+
+	//room for the whole burst now, so updateBurst never allocates
+	projectiles.ensureHeadroom(maxProjectiles);
 
+	isFiring = true;
+	firedProjectiles = 0;
+	timeSinceLastShot = 0.0;
+	fireProjectile(projectiles, projectileTexture, velocity); 
+	firedProjectiles++;
+	shotsFired++;
+	return true;
+}
+
+void Player::updateBurst(EntityRegistry& projectiles, int projectileTexture, int velocity, double tickSeconds)
+{
 	const double fireDelay = 0.09;
-	if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_SPACE && !isFiring)
+	if (!isFiring)
 	{
-		isFiring = true;
-		firedProjectiles = 0;
-		lastFireTime = clock();
-		fireProjectile(projectiles, projectileTexture, velocity); 
-		firedProjectiles++;
+		return;
 	}
 
-	if (isFiring)
+	timeSinceLastShot += tickSeconds;
+	if (timeSinceLastShot >= fireDelay)
 	{
-		clock_t currentTime = clock();
-		double elapsedTime = double(currentTime - lastFireTime) / CLOCKS_PER_SEC;
+		fireProjectile(projectiles, projectileTexture, velocity);
+		firedProjectiles++;
+		shotsFired++;
+		timeSinceLastShot = 0.0;
 
-		if (elapsedTime >= fireDelay)
+		if (firedProjectiles >= maxProjectiles)
 		{
-			fireProjectile(projectiles, projectileTexture, velocity);
-			firedProjectiles++;
-			lastFireTime = currentTime; 
-
-			if (firedProjectiles >= maxProjectiles)
-			{
-				isFiring = false; 
-			}
+			isFiring = false; 
 		}
 	}
 }
@@ -92,23 +123,26 @@ void Player::shoot(SDL_Event& event, std::vector<Entity>& projectiles, SDL_Textu
 
 
 
-bool Player::outOfBounds(std::vector<Entity>& projectile, int& windowWidth, int& windowHeight, bool* detectOutOfBounds, Audio& audio2)
+bool Player::outOfBounds(EntityRegistry& projectile, int& windowWidth, int& windowHeight, bool* detectOutOfBounds, GameEventBuffer& events)
 {
 	*detectOutOfBounds = false;
 
-	for (auto it = projectile.begin(); it != projectile.end(); )
+	const float* positionX = projectile.getPositionsX();
+	const float* positionY = projectile.getPositionsY();
+	const uint8_t* flags = projectile.getFlags();
+	for (size_t i = 0; i < projectile.size(); ++i)
 	{
-		if (it->getX() < 0 || it->getX() > windowWidth || it->getY() < 0
-			|| it->getY() > windowHeight || it->getY() < 64)
+		if (flags[i] & ENTITY_DEAD)
 		{
-			it = projectile.erase(it);
-			*detectOutOfBounds = true;
-			audio2.playDeathSound();
-			//std::cout << "Projectiles remaining: " << projectile.size() << "\n";
-
+			continue;
 		}
-		else {
-			++it;
+		if (positionX[i] < 0 || positionX[i] > windowWidth || positionY[i] < 0
+			|| positionY[i] > windowHeight || positionY[i] < 64)
+		{
+			//removed by flushRemovals at the end of the tick
+			projectile.kill(i);
+			*detectOutOfBounds = true;
+			events.push(EVENT_PROJECTILE_LOST, static_cast<uint32_t>(i));
 		}
 	}
 	return *detectOutOfBounds;
@@ -118,15 +152,21 @@ bool Player::outOfBounds(std::vector<Entity>& projectile, int& windowWidth, int&
 void Player::setX(int x) { rect.x = x; }
 void Player::setY(int y) { rect.y = y; }
 
-void Player::updateMaxProj(Audio& audio3) {
-	if (score % 10 == 0 && score != 0) {
+void Player::setMaxProjectiles(int projectiles, int points) {
+	maxProjectiles = projectiles;
+	pointsPerLevel = points;
+}
+
+void Player::updateMaxProj(GameEventBuffer& events) {
+	//pointsPerLevel 0 turns levelling off
+	if (pointsPerLevel > 0 && score % pointsPerLevel == 0 && score != 0) {
 		maxProjectiles++;
-		audio3.playLevelUpSound();
+		events.push(EVENT_LEVEL_UP);
 		//std::cout << "Max projectiles: " << maxProjectiles << std::endl;
 	}
 }
-void Player::incrementScore(Audio& audio3) {
-	updateMaxProj(audio3);
+void Player::incrementScore(GameEventBuffer& events) {
+	updateMaxProj(events);
 	score += 1;
 }
 
@@ -134,14 +174,14 @@ int Player::getScore() const {
 	return score;
 }
 
-void Player::render(SDL_Renderer* renderer)
+Rect Player::getRect() const
 {
-	SDL_RenderCopy(renderer, texture, nullptr, &rect);
+	return rect;
 }
 
-SDL_Rect Player::getRect() const
+int Player::getTexture() const
 {
-	return rect;
+	return texture;
 }
 
 bool Player::getp_OutOfBounds() const
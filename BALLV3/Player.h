@@ -1,16 +1,16 @@
 #pragma once
 #ifndef Player_h
 #define Player_h
-#include <SDL.h>
-#include <SDL_image.h>
 #include <vector>
 #include <iostream>
 #include <ctime>
+#include <cstdint>
 
 
 #include "Entities.h"
-#include "Collisions.h"
-#include "Audio.h"
+#include "EntityRegistry.h"
+#include "SimTypes.h"
+#include "GameEvents.h"
 
 
 class Player
@@ -21,91 +21,110 @@ public:
 	 *
 	 * @param width The width of the player's texture.
 	 * @param height The height of the player's texture.
-	 * @param texture The SDL_Texture representing the player's sprite.
+	 * @param texture The TextureId of the player's sprite.
 	 * @param windowWidth A reference to the width of the game window.
 	 * @param windowHeight A reference to the height of the game window.
 	 */
-	Player(int width, int height, SDL_Texture* texture, int& windowWidth, int& windowHeight);
+	Player(int width, int height, int texture, int& windowWidth, int& windowHeight);
 
 	/**
-	 * @brief This function handles the player's aiming behavior.
+	 * @brief Points the player's aim at a position on the playfield.
 	 *
-	 * The aiming function is responsible for managing the player's aiming behavior.
-	 * It does not perform any game logic or update the player's position.
+	 * The game passes the mouse position every frame, a headless run passes wherever its bot wants to shoot.
+	 * The aim is stored and used by every projectile fired until the next call.
+	 *
+	 * @param targetX The x-coordinate to aim at.
+	 * @param targetY The y-coordinate to aim at.
 	 *
 	 * @return This function does not return any value.
 	 */
-	void aiming() const;
+	void aimAt(int targetX, int targetY);
+
+	//aim angle in radians, 0 is to the right and positive angles turn downward
+	//the angle is snapped to one of aimSteps directions, so a replay can store it exactly in 16 bits
+	void setAimAngle(double angle);
+	double getAimAngle() const;
+
+	//the snapped aim, 0 is to the right, aimSteps / 4 straight down
+	void setAimStep(uint16_t step);
+	uint16_t getAimStep() const;
+
+	//projectiles fired since the player was created, bursts included
+	uint32_t getShotsFired() const;
 
 	/**
-	 * @brief Renders the player's sprite to the game window.
+	 * @brief Fires a projectile from the player's position.
 	 *
-	 * This function is responsible for drawing the player's sprite to the game window.
-	 * It uses the SDL_Renderer to render the player's texture to the specified position and size.
+	 * This function creates a new projectile entity and adds it to the projectile registry.
+	 * The projectile is positioned at the player's current position and moves with the specified velocity.
 	 *
-	 * @param renderer The SDL_Renderer used for rendering the game graphics.
+	 * @param projectile A reference to the registry of projectile entities.
+	 * @param projectileTexture The TextureId of the projectile's sprite.
+	 * @param velocity The velocity at which the projectile moves.
 	 *
 	 * @return This function does not return any value.
 	 */
-	void render(SDL_Renderer* renderer);
+	void fireProjectile(EntityRegistry& projectile, int projectileTexture, int velocity) const;
 
 	/**
-	 * @brief Fires a projectile from the player's position.
+	 * @brief Handles the player's shooting behavior.
 	 *
-	 * This function creates a new projectile entity and adds it to the projectile vector.
-	 * The projectile is positioned at the player's current position and moves with the specified velocity.
+	 * Called when SPACE is pressed. If no burst is in progress, fires the first projectile
+	 * of a burst from the player's position. The projectile is added to the projectile registry.
+	 * The rest of the burst is fired by updateBurst.
 	 *
-	 * @param projectile A reference to the vector of projectile entities.
-	 * @param projectileTexture The SDL_Texture representing the projectile's sprite.
+	 * @param projectile A reference to the registry of projectile entities.
+	 * @param projectileTexture The TextureId of the projectile's sprite.
 	 * @param velocity The velocity at which the projectile moves.
 	 *
-	 * @return This function does not return any value.
+	 * @return true if a burst was started, false if one was already in progress.
 	 */
-	void fireProjectile(std::vector<Entity>& projectile, SDL_Texture* projectileTexture, int velocity) const;
+	bool shoot(EntityRegistry& projectile, int projectileTexture, int velocity);
 
 	/**
-	 * @brief Handles the player's shooting behavior.
+	 * @brief Fires the remaining projectiles of a burst, one every fireDelay seconds of game time.
 	 *
-	 * This function checks for a shooting event (e.g., mouse button click) and fires a projectile
-	 * from the player's position if the event occurs. The projectile is added to the projectile vector./
+	 * Called once per simulation tick, so the spacing of a burst depends on the tick rate
+	 * and not on how often events arrive or how fast the machine is.
 	 *
-	 * @param event The SDL_Event object containing the current event.
-	 * @param projectile A reference to the vector of projectile entities.
-	 * @param projectileTexture The SDL_Texture representing the projectile's sprite.
+	 * @param projectile A reference to the registry of projectile entities.
+	 * @param projectileTexture The TextureId of the projectile's sprite.
 	 * @param velocity The velocity at which the projectile moves.
+	 * @param tickSeconds The length of one simulation tick in seconds.
 	 *
 	 * @return This function does not return any value.
 	 */
-	void shoot(SDL_Event& event, std::vector<Entity>& projectile, SDL_Texture* projectileTexture, int velocity) const;
+	void updateBurst(EntityRegistry& projectile, int projectileTexture, int velocity, double tickSeconds);
 
 	/**
 	 * @brief Checks if any projectile in the vector has gone out of bounds.
 	 *
-	 * This function iterates through the projectile vector and checks if any projectile has
-	 * gone out of bounds by comparing its position with the window dimensions. If a projectile
-	 * is found to be out of bounds, it sets the detectOutOfBounds flag to true and plays an
-	 * audio clip.
+	 * This function iterates through the position columns of the projectile registry and checks if any
+	 * projectile has gone out of bounds by comparing its position with the window dimensions. If a projectile
+	 * is found to be out of bounds, it is killed (removed at the end of the tick), the detectOutOfBounds
+	 * flag is set to true and a projectile-lost event is pushed.
 	 *
-	 * @param projectile A reference to the vector of projectile entities.
+	 * @param projectile A reference to the registry of projectile entities.
 	 * @param windowWidth A reference to the width of the game window.
 	 * @param windowHeight A reference to the height of the game window.
 	 * @param detectOutOfBounds A pointer to a boolean flag indicating whether any projectile is out of bounds.
-	 * @param audio2 A reference to the Audio object used for playing audio clips.
+	 * @param events The tick's event buffer.
 	 *
 	 * @return Returns true if any projectile is found to be out of bounds, otherwise returns false.
 	 */
-	static bool outOfBounds(std::vector<Entity>& projectile, int& windowWidth, int& windowHeight, bool* detectOutOfBounds, Audio& audio2);
+	static bool outOfBounds(EntityRegistry& projectile, int& windowWidth, int& windowHeight, bool* detectOutOfBounds, GameEventBuffer& events);
 
 	/**
-	 * @brief Retrieves the SDL_Rect representing the player's position and dimensions.
+	 * @brief Retrieves the Rect representing the player's position and dimensions.
 	 *
-	 * This function returns a SDL_Rect structure that contains the player's position and dimensions.
+	 * This function returns a Rect structure that contains the player's position and dimensions.
 	 * The rect's x and y coordinates represent the top-left corner of the player, while the width and height
 	 * represent the player's dimensions.
 	 *
-	 * @return A SDL_Rect structure representing the player's position and dimensions.
+	 * @return A Rect structure representing the player's position and dimensions.
 	 */
-	SDL_Rect getRect() const;
+	Rect getRect() const;
+	int getTexture() const;
 
 	//grouping of getter functions
 	bool getp_OutOfBounds() const;
@@ -119,16 +138,28 @@ public:
 	void setY(int y);
 
 	//update the amount of projectiles per burst every 10 points
-	// also play "levelUp sound"
-	void updateMaxProj(Audio& audio3);
+	// also push a level-up event
+	void updateMaxProj(GameEventBuffer& events);
+	//burst size at the start, and the score between one more projectile per burst
+	void setMaxProjectiles(int projectiles, int pointsPerLevel);
 	//score counter
 	//every entity eliminated
-	void incrementScore(Audio& audio3);
+	void incrementScore(GameEventBuffer& events);
 	int getScore() const;
 
 private:
 	int score = 0;
 	int maxProjectiles = 2;
+	int pointsPerLevel = 10;
+
+	//burst in progress
+	bool isFiring = false;
+	int firedProjectiles = 0;
+	double timeSinceLastShot = 0.0;
+
+	//straight down until the first aimAt
+	uint16_t aimStep = 16384;
+	uint32_t shotsFired = 0;
 	
 
 	bool detectOutOfBounds = false;
@@ -136,8 +167,8 @@ private:
 	float projectileY;
 	float velocityX;
 	float velocityY;
-	SDL_Rect rect;
-	SDL_Texture* texture;
+	Rect rect;
+	int texture;
 };
 
 #endif // !Player_h
@@ -0,0 +1,162 @@
+#include "PoissonSpawner.h"
+#include "EntityRegistry.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float pi = 3.14159265358979f;
+}
+
+PoissonSpawner::PoissonSpawner(float minimumDistance, int candidatesPerPoint)
+    : minimumDistance(minimumDistance), candidatesPerPoint(candidatesPerPoint),
+    cellSize(minimumDistance / std::sqrt(2.0f))
+{
+}
+
+void PoissonSpawner::resetGrid(float left, float top, float width, float height)
+{
+    gridLeft = left - minimumDistance;
+    gridTop = top - minimumDistance;
+    columns = static_cast<int>(std::ceil((width + 2 * minimumDistance) / cellSize));
+    rows = static_cast<int>(std::ceil((height + 2 * minimumDistance) / cellSize));
+
+    //assign keeps the capacity, so a band of the same size never allocates again
+    cellHead.assign(static_cast<size_t>(columns) * rows, -1);
+    nextInCell.clear();
+    occupied.clear();
+    points.clear();
+    active.clear();
+}
+
+int PoissonSpawner::cellOf(float x, float y) const
+{
+    const int cx = static_cast<int>(std::floor((x - gridLeft) / cellSize));
+    const int cy = static_cast<int>(std::floor((y - gridTop) / cellSize));
+    if (cx < 0 || cy < 0 || cx >= columns || cy >= rows) {
+        return -1;
+    }
+    return cy * columns + cx;
+}
+
+void PoissonSpawner::insert(float x, float y)
+{
+    const int cell = cellOf(x, y);
+    if (cell < 0) {
+        return;
+    }
+    nextInCell.push_back(cellHead[cell]);
+    cellHead[cell] = static_cast<int32_t>(occupied.size());
+    occupied.push_back({ x, y });
+}
+
+bool PoissonSpawner::isClear(float x, float y) const
+{
+    //a cell is r/sqrt(2) wide, so anything closer than r is at most two cells away
+    const int cx = static_cast<int>(std::floor((x - gridLeft) / cellSize));
+    const int cy = static_cast<int>(std::floor((y - gridTop) / cellSize));
+    const float limit = minimumDistance * minimumDistance;
+
+    for (int ny = std::max(cy - 2, 0); ny <= std::min(cy + 2, rows - 1); ++ny) {
+        for (int nx = std::max(cx - 2, 0); nx <= std::min(cx + 2, columns - 1); ++nx) {
+            for (int32_t k = cellHead[ny * columns + nx]; k >= 0; k = nextInCell[k]) {
+                const float dx = occupied[k].x - x;
+                const float dy = occupied[k].y - y;
+                if (dx * dx + dy * dy < limit) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void PoissonSpawner::accept(float x, float y)
+{
+    insert(x, y);
+    active.push_back(static_cast<uint32_t>(points.size()));
+    points.push_back({ x, y });
+}
+
+size_t PoissonSpawner::place(const EntityRegistry& entities, Random& rng, float left, float top, float width, float height, int count)
+{
+    resetGrid(left, top, width, height);
+    if (count <= 0 || width < 1.0f || height < 1.0f) {
+        return 0;
+    }
+
+    const float* entityX = entities.getPositionsX();
+    const float* entityY = entities.getPositionsY();
+    const uint8_t* entityFlags = entities.getFlags();
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (!(entityFlags[i] & (ENTITY_PROJECTILE | ENTITY_WALL | ENTITY_DEAD))) {
+            insert(entityX[i], entityY[i]);
+        }
+    }
+
+    //whole pixels, like every planet position, and checked after rounding so flooring can't break the spacing
+    const float right = left + width, bottom = top + height;
+    auto inBand = [&](float x, float y) {
+        return x >= left && x < right && y >= top && y < bottom;
+    };
+
+    while (points.size() < static_cast<size_t>(count)) {
+        if (active.empty()) {
+            //a new seed anywhere in the band, this also starts every separate patch between old planets
+            bool seeded = false;
+            for (int attempt = 0; attempt < candidatesPerPoint && !seeded; ++attempt) {
+                const float x = std::floor(left + rng.nextFloat() * width);
+                const float y = std::floor(top + rng.nextFloat() * height);
+                if (inBand(x, y) && isClear(x, y)) {
+                    accept(x, y);
+                    seeded = true;
+                }
+            }
+            if (!seeded) {
+                break;
+            }
+            continue;
+        }
+
+        const size_t pick = static_cast<size_t>(rng.nextInt(static_cast<int>(active.size())));
+        const Point around = points[active[pick]];
+        bool found = false;
+        for (int attempt = 0; attempt < candidatesPerPoint && !found; ++attempt) {
+            //uniform over the area of the annulus between r and 2r
+            const float angle = rng.nextFloat() * 2.0f * pi;
+            const float radius = minimumDistance * std::sqrt(1.0f + 3.0f * rng.nextFloat());
+            const float x = std::floor(around.x + radius * std::cos(angle));
+            const float y = std::floor(around.y + radius * std::sin(angle));
+            if (inBand(x, y) && isClear(x, y)) {
+                accept(x, y);
+                found = true;
+            }
+        }
+        if (!found) {
+            //nothing fits around it any more
+            active[pick] = active.back();
+            active.pop_back();
+        }
+    }
+    return points.size();
+}
+
+void PoissonSpawner::reserve(size_t planets)
+{
+    nextInCell.reserve(planets);
+    occupied.reserve(planets);
+    points.reserve(planets);
+    active.reserve(planets);
+}
+
+const std::vector<PoissonSpawner::Point>& PoissonSpawner::getPoints() const
+{
+    return points;
+}
+
+float PoissonSpawner::getMinimumDistance() const
+{
+    return minimumDistance;
+}
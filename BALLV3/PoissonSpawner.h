@@ -0,0 +1,87 @@
+#pragma once
+#ifndef PoissonSpawner_h
+#define PoissonSpawner_h
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class EntityRegistry;
+class Random;
+
+/*
+* places a wave of planets with Bridson's Poisson-disc sampling
+*
+* the spawn band is covered by a grid of r/sqrt(2) cells, so a spaced point owns its cell and
+* checking a candidate only looks at the 5x5 cells around it instead of every body in the world
+* planets already near the band go into the grid first and are kept clear of as well
+*/
+class PoissonSpawner
+{
+public:
+    struct Point
+    {
+        float x, y;
+    };
+
+    /**
+     * @param minimumDistance The least distance between the top-left corners of two planets.
+     * @param candidatesPerPoint Tries around an active point before it is retired, Bridson's k.
+     */
+    explicit PoissonSpawner(float minimumDistance = 128.0f, int candidatesPerPoint = 30);
+
+    /**
+     * Samples up to count whole-pixel points in [left, left + width) x [top, top + height),
+     * each at least the minimum distance from every other point and from every live planet of the registry.
+     *
+     * Stops early only once neither the active points nor fresh darts into the band find room,
+     * so a short result means the band is as good as full.
+     *
+     * @param entities The registry whose planets the wave must keep clear of. Walls, projectiles and dead bodies are ignored.
+     * @param rng The world's generator, every candidate is drawn from it.
+     * @param left The x-coordinate of the left edge of the band.
+     * @param top The y-coordinate of the top edge of the band.
+     * @param width The width of the band in pixels.
+     * @param height The height of the band in pixels.
+     * @param count The number of points wanted.
+     *
+     * @return The number of points placed, see getPoints.
+     */
+    size_t place(const EntityRegistry& entities, Random& rng, float left, float top, float width, float height, int count);
+
+    /**
+     * Sizes the storage for bands holding up to the given number of planets, so place doesn't allocate below it.
+     *
+     * @param planets The number of planets, old and new, a band is expected to see.
+     */
+    void reserve(size_t planets);
+
+    //the points of the last place call, in the order they were found
+    const std::vector<Point>& getPoints() const;
+
+    float getMinimumDistance() const;
+
+private:
+    void resetGrid(float left, float top, float width, float height);
+    //index of the cell holding a point, or -1 outside the grid
+    int cellOf(float x, float y) const;
+    void insert(float x, float y);
+    bool isClear(float x, float y) const;
+    void accept(float x, float y);
+
+    float minimumDistance;
+    int candidatesPerPoint;
+    float cellSize;
+
+    //the grid covers the band plus one minimum distance on every side, for the planets bordering it
+    float gridLeft = 0.0f, gridTop = 0.0f;
+    int columns = 0, rows = 0;
+    //each cell heads a list through nextInCell, a cell can hold several bodies that were placed before spacing was enforced
+    std::vector<int32_t> cellHead;
+    std::vector<int32_t> nextInCell;
+    std::vector<Point> occupied;
+
+    std::vector<Point> points;
+    std::vector<uint32_t> active;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    //events are stored in chunks that never move, so a reader never sees a reallocation
+    const size_t chunkSize = 16384;
+    //a million zones per thread, about 24 MB, then new zones are dropped
+    const size_t maxChunks = 64;
+
+    struct ThreadBuffer
+    {
+        uint32_t threadId = 0;
+        char name[32] = {};
+        //events below this index are complete, written by the owning thread only
+        std::atomic<size_t> count{ 0 };
+        ProfileEvent* chunks[maxChunks] = {};
+    };
+
+    std::mutex buffersMutex;
+    //buffers outlive their threads so a trace written after a join still has their zones
+    std::vector<ThreadBuffer*>& buffers()
+    {
+        static std::vector<ThreadBuffer*> all;
+        return all;
+    }
+    std::atomic<uint64_t> dropped(0);
+
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    ThreadBuffer& currentBuffer()
+    {
+        if (!threadBuffer) {
+            //the only lock, taken once per thread
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            threadBuffer = new ThreadBuffer();
+            threadBuffer->threadId = static_cast<uint32_t>(buffers().size() + 1);
+            buffers().push_back(threadBuffer);
+        }
+        return *threadBuffer;
+    }
+
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+}
+
+bool Profiler::isEnabled()
+{
+#if defined(FB_PROFILE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t Profiler::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs)
+{
+    ThreadBuffer& buffer = currentBuffer();
+    const size_t index = buffer.count.load(std::memory_order_relaxed);
+    const size_t chunk = index / chunkSize;
+    if (chunk >= maxChunks) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!buffer.chunks[chunk]) {
+        buffer.chunks[chunk] = new ProfileEvent[chunkSize];
+    }
+
+    buffer.chunks[chunk][index % chunkSize] = { name, startNs, endNs };
+    //publishes the event, and the chunk pointer with it, to writeChromeTrace
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    ThreadBuffer& buffer = currentBuffer();
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    strncpy(buffer.name, name, sizeof(buffer.name) - 1);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+    std::vector<ThreadBuffer*> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        snapshot = buffers();
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    char line[256];
+    for (ThreadBuffer* buffer : snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            if (buffer->name[0]) {
+                snprintf(line, sizeof(line), "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                    buffer->threadId, buffer->name);
+                out << (first ? "" : ",\n") << line;
+                first = false;
+            }
+        }
+
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const ProfileEvent& event = buffer->chunks[i / chunkSize][i % chunkSize];
+            //microseconds with the nanoseconds kept as decimals
+            snprintf(line, sizeof(line), "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                event.name, buffer->threadId, event.startNs / 1000.0, (event.endNs - event.startNs) / 1000.0);
+            out << (first ? "" : ",\n") << line;
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        std::cerr << "Could not write trace " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t Profiler::getDroppedCount()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
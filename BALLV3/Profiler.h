@@ -0,0 +1,95 @@
+#pragma once
+#ifndef Profiler_h
+#define Profiler_h
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+* scoped profiling zones written out as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+*
+*     void Collisions::applyGravity(...)
+*     {
+*         PROFILE_ZONE("applyGravity");
+*         ...
+*     }
+*
+* zones only exist when the build defines FB_PROFILE (make PROFILE=1, or add it to the preprocessor
+* definitions in Visual Studio), otherwise PROFILE_ZONE expands to nothing and costs nothing
+*
+* every thread records into its own buffer with no locks: the thread is the only writer and publishes
+* each event by bumping an atomic count, so a trace can be written while other threads keep recording
+*/
+
+struct ProfileEvent
+{
+    //a string literal, only the pointer is kept
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+class Profiler
+{
+public:
+    //true when the zones were compiled in
+    static bool isEnabled();
+
+    //nanoseconds since the profiler's epoch, the first call in the process
+    static uint64_t now();
+
+    //adds a finished zone to the calling thread's buffer
+    static void record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * Names the calling thread in the trace. Threads without a name show up by number.
+     *
+     * @param name The name to show, copied.
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * Writes every zone recorded so far, on every thread, as Chrome Trace Event JSON.
+     * Recording carries on, a later call writes a longer trace.
+     *
+     * @param path The file to create or overwrite.
+     *
+     * @return true if the whole file was written, false otherwise.
+     */
+    static bool writeChromeTrace(const std::string& path);
+
+    //zones dropped because a thread filled its buffer
+    static uint64_t getDroppedCount();
+};
+
+//times the enclosing scope
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name)
+        : name(name), startNs(Profiler::now())
+    {
+    }
+
+    ~ProfileZone()
+    {
+        Profiler::record(name, startNs, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    uint64_t startNs;
+};
+
+#if defined(FB_PROFILE)
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) do {} while (0)
+#endif
+
+#endif
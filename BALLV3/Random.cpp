@@ -0,0 +1,52 @@
+#include "Random.h"
+
+namespace
+{
+    const uint64_t golden = 0x9E3779B97F4A7C15ull;
+
+    inline uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    //top 24 bits, every float in [0, 1) with that spacing is exact
+    inline float toUnit(uint64_t bits)
+    {
+        return static_cast<float>(bits >> 40) * (1.0f / 16777216.0f);
+    }
+}
+
+Random::Random(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void Random::seed(uint64_t seed)
+{
+    initialSeed = seed;
+    counter = seed;
+}
+
+uint64_t Random::next()
+{
+    counter += golden;
+    return mix(counter);
+}
+
+int Random::nextInt(int bound)
+{
+    const uint64_t bits = next() >> 32;
+    return static_cast<int>((bits * static_cast<uint64_t>(bound)) >> 32);
+}
+
+float Random::nextFloat()
+{
+    return toUnit(next());
+}
+
+uint64_t Random::getSeed() const
+{
+    return initialSeed;
+}
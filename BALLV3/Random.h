@@ -0,0 +1,49 @@
+#pragma once
+#ifndef Random_h
+#define Random_h
+#include <cstdint>
+
+/*
+* counter-based generator (SplitMix64): output n is a fixed hash of seed + n * constant
+* each World owns one, so two worlds never share a stream and the same seed replays bit for bit
+*/
+class Random
+{
+public:
+    /**
+     * Creates a generator at the start of the stream for the given seed.
+     *
+     * @param seed Any 64-bit value. Equal seeds produce equal streams on every platform.
+     */
+    explicit Random(uint64_t seed = 0);
+
+    //restarts the stream from a new seed
+    void seed(uint64_t seed);
+
+    //next raw 64 bits of the stream
+    uint64_t next();
+
+    /**
+     * Draws an integer in [0, bound).
+     *
+     * Uses the high bits of a 64x32 multiply instead of %, which is unbiased enough for
+     * small bounds and never divides.
+     *
+     * @param bound The exclusive upper limit, must be positive.
+     *
+     * @return An integer in [0, bound).
+     */
+    int nextInt(int bound);
+
+    //uniform float in [0, 1), 24 bits of precision
+    float nextFloat();
+
+    //the seed the stream was started from, for logs and replays
+    uint64_t getSeed() const;
+
+private:
+    uint64_t initialSeed;
+    uint64_t counter;
+};
+
+#endif
@@ -0,0 +1,311 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+    const char magic[4] = { 'F', 'B', 'R', 'Q' };
+    const uint8_t version = 2;
+    //version 1 had no colours, every command was white
+    const uint8_t versionWithoutColor = 1;
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool getVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            const uint8_t byte = in[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //bodies above the screen have negative coordinates, zigzag keeps them short
+    void putSigned(std::vector<uint8_t>& out, int value)
+    {
+        putVarint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    bool getSigned(const std::vector<uint8_t>& in, size_t& pos, int& value)
+    {
+        uint64_t raw;
+        if (!getVarint(in, pos, raw)) {
+            return false;
+        }
+        value = static_cast<int>(static_cast<uint32_t>(raw >> 1) ^ (0u - static_cast<uint32_t>(raw & 1)));
+        return true;
+    }
+
+    void putRect(std::vector<uint8_t>& out, const Rect& rect)
+    {
+        putSigned(out, rect.x);
+        putSigned(out, rect.y);
+        putSigned(out, rect.w);
+        putSigned(out, rect.h);
+    }
+
+    bool getRect(const std::vector<uint8_t>& in, size_t& pos, Rect& rect)
+    {
+        return getSigned(in, pos, rect.x) && getSigned(in, pos, rect.y)
+            && getSigned(in, pos, rect.w) && getSigned(in, pos, rect.h);
+    }
+}
+
+//QUEUE
+
+RenderQueue::RenderQueue(SDL_Renderer* renderer)
+    : renderer(renderer), batch(renderer)
+{
+}
+
+void RenderQueue::setRenderer(SDL_Renderer* p_renderer)
+{
+    renderer = p_renderer;
+    batch.setRenderer(p_renderer);
+}
+
+int RenderQueue::addTexture(SDL_Texture* texture)
+{
+    if (static_cast<int>(textures.size()) >= maxTextures) {
+        std::cout << "Render queue is out of texture handles" << std::endl;
+        return -1;
+    }
+    textures.push_back(texture);
+    return static_cast<int>(textures.size()) - 1;
+}
+
+void RenderQueue::setTexture(int handle, SDL_Texture* texture)
+{
+    if (handle >= 0 && handle < static_cast<int>(textures.size())) {
+        textures[handle] = texture;
+    }
+}
+
+SDL_Texture* RenderQueue::getTexture(int handle) const
+{
+    if (handle < 0 || handle >= static_cast<int>(textures.size())) {
+        return nullptr;
+    }
+    return textures[handle];
+}
+
+int RenderQueue::findTexture(SDL_Texture* texture) const
+{
+    for (size_t i = 0; i < textures.size(); ++i) {
+        if (textures[i] == texture) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void RenderQueue::reserve(size_t count)
+{
+    commands.reserve(count);
+    sorted.reserve(count);
+    batch.reserve(count);
+}
+
+void RenderQueue::sort()
+{
+    //LSD radix sort on the two key bytes, texture then layer, each pass stable
+    sorted.resize(commands.size());
+    for (int shift = 0; shift < 16; shift += 8) {
+        size_t offsets[256] = {};
+        for (const RenderCommand& command : commands) {
+            offsets[(command.key >> shift) & 0xFF]++;
+        }
+        //a byte every command shares needs no pass, the common case for the texture byte
+        if (!commands.empty() && offsets[(commands.front().key >> shift) & 0xFF] == commands.size()) {
+            continue;
+        }
+
+        size_t start = 0;
+        for (size_t& offset : offsets) {
+            const size_t count = offset;
+            offset = start;
+            start += count;
+        }
+        for (const RenderCommand& command : commands) {
+            sorted[offsets[(command.key >> shift) & 0xFF]++] = command;
+        }
+        commands.swap(sorted);
+    }
+}
+
+size_t RenderQueue::submit(bool frame)
+{
+    if (recording && frame) {
+        recording->addFrame(commands, *this);
+    }
+
+    sort();
+    batch.resetDrawCalls();
+    for (const RenderCommand& command : commands) {
+        SDL_Texture* texture = getTexture(command.texture);
+        if (!texture) {
+            continue;
+        }
+        const SDL_FRect dst = { static_cast<float>(command.dst.x), static_cast<float>(command.dst.y),
+            static_cast<float>(command.dst.w), static_cast<float>(command.dst.h) };
+        batch.draw(texture, command.src, dst, command.color);
+    }
+    batch.flush();
+    commands.clear();
+    return batch.getDrawCalls();
+}
+
+void RenderQueue::setRecording(RenderRecording* p_recording)
+{
+    recording = p_recording;
+}
+
+//RECORDING
+
+void RenderRecording::addFrame(const std::vector<RenderCommand>& frameCommands, const RenderQueue& queue)
+{
+    frameStarts.push_back(static_cast<uint32_t>(commands.size()));
+    commands.insert(commands.end(), frameCommands.begin(), frameCommands.end());
+
+    for (const RenderCommand& command : frameCommands) {
+        if (command.texture >= textureSizes.size()) {
+            textureSizes.resize(command.texture + 1, SDL_Point{ 0, 0 });
+        }
+        SDL_Point& size = textureSizes[command.texture];
+        SDL_Texture* texture = queue.getTexture(command.texture);
+        if (size.x == 0 && texture) {
+            SDL_QueryTexture(texture, nullptr, nullptr, &size.x, &size.y);
+        }
+    }
+}
+
+void RenderRecording::replayFrame(size_t frame, RenderQueue& queue) const
+{
+    const size_t first = frameStarts[frame];
+    const size_t last = frame + 1 < frameStarts.size() ? frameStarts[frame + 1] : commands.size();
+    for (size_t i = first; i < last; ++i) {
+        const RenderCommand& command = commands[i];
+        queue.push(command.key >> 8, command.texture, command.src, command.dst, command.color);
+    }
+}
+
+SDL_Point RenderRecording::getTextureSize(int handle) const
+{
+    if (handle < 0 || handle >= static_cast<int>(textureSizes.size())) {
+        return { 0, 0 };
+    }
+    return textureSizes[handle];
+}
+
+bool RenderRecording::save(const std::string& path) const
+{
+    std::vector<uint8_t> file(magic, magic + sizeof(magic));
+    file.push_back(version);
+
+    putVarint(file, textureSizes.size());
+    for (const SDL_Point& size : textureSizes) {
+        putVarint(file, static_cast<uint64_t>(size.x));
+        putVarint(file, static_cast<uint64_t>(size.y));
+    }
+
+    putVarint(file, frameStarts.size());
+    for (size_t frame = 0; frame < frameStarts.size(); ++frame) {
+        const size_t first = frameStarts[frame];
+        const size_t last = frame + 1 < frameStarts.size() ? frameStarts[frame + 1] : commands.size();
+        putVarint(file, last - first);
+        for (size_t i = first; i < last; ++i) {
+            putVarint(file, commands[i].key >> 8);
+            putVarint(file, commands[i].texture);
+            putRect(file, commands[i].src);
+            putRect(file, commands[i].dst);
+            const SDL_Color& color = commands[i].color;
+            file.insert(file.end(), { color.r, color.g, color.b, color.a });
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        std::cerr << "Could not write render recording " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RenderRecording::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Could not open render recording " << path << std::endl;
+        return false;
+    }
+    const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (file.size() < sizeof(magic) + 1 || !std::equal(magic, magic + sizeof(magic), file.begin()) || (file[4] != version && file[4] != versionWithoutColor)) {
+        std::cerr << path << " is not a render recording" << std::endl;
+        return false;
+    }
+
+    commands.clear();
+    frameStarts.clear();
+    textureSizes.clear();
+
+    const bool hasColor = file[4] != versionWithoutColor;
+    size_t pos = sizeof(magic) + 1;
+    uint64_t textureCount = 0, frameCount = 0;
+    bool ok = getVarint(file, pos, textureCount) && textureCount <= static_cast<uint64_t>(RenderQueue::maxTextures);
+    for (uint64_t i = 0; ok && i < textureCount; ++i) {
+        uint64_t width, height;
+        ok = getVarint(file, pos, width) && getVarint(file, pos, height);
+        textureSizes.push_back({ static_cast<int>(width), static_cast<int>(height) });
+    }
+
+    ok = ok && getVarint(file, pos, frameCount);
+    for (uint64_t frame = 0; ok && frame < frameCount; ++frame) {
+        uint64_t count;
+        ok = getVarint(file, pos, count);
+        frameStarts.push_back(static_cast<uint32_t>(commands.size()));
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            uint64_t layer, texture;
+            RenderCommand command;
+            ok = getVarint(file, pos, layer) && getVarint(file, pos, texture) && layer < LAYER_COUNT
+                && texture < textureCount && getRect(file, pos, command.src) && getRect(file, pos, command.dst);
+            command.key = static_cast<uint16_t>((layer << 8) | texture);
+            command.texture = static_cast<uint16_t>(texture);
+            command.color = { 255, 255, 255, 255 };
+            if (ok && hasColor) {
+                ok = pos + 4 <= file.size();
+                if (ok) {
+                    command.color = { file[pos], file[pos + 1], file[pos + 2], file[pos + 3] };
+                    pos += 4;
+                }
+            }
+            if (ok) {
+                commands.push_back(command);
+            }
+        }
+    }
+
+    if (!ok) {
+        std::cerr << path << " is truncated" << std::endl;
+        commands.clear();
+        frameStarts.clear();
+        textureSizes.clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,167 @@
+#pragma once
+#ifndef RenderQueue_h
+#define RenderQueue_h
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SimTypes.h"
+#include "SpriteBatch.h"
+
+/*
+* a frame's draws recorded as commands, sorted, then submitted in one go
+*
+* a command's key is its layer then its texture, radix sorted (stable) once per frame,
+* so each texture of a layer is one SpriteBatch run and commands with the same key keep the
+* order they were pushed in: bodies on one atlas page still draw projectiles first, then planets
+* textures are referred to by small handles, so a recorded frame can be replayed with other textures
+*/
+
+//draw order, lowest first
+enum RenderLayer
+{
+    LAYER_BACKGROUND = 0,
+    LAYER_BODIES,
+    LAYER_PLAYER,
+    LAYER_UI,
+    LAYER_COUNT
+};
+
+struct RenderCommand
+{
+    //layer in the high byte, texture handle in the low byte
+    uint16_t key;
+    uint16_t texture;
+    //pixels of the texture to draw
+    Rect src;
+    //where they go, in window pixels
+    Rect dst;
+    //multiplies the texture, white for sprites, the text colour for glyphs
+    SDL_Color color;
+};
+
+class RenderRecording;
+
+class RenderQueue
+{
+public:
+    //the most textures a queue can refer to, handles fit the low byte of the key
+    static const int maxTextures = 256;
+
+    explicit RenderQueue(SDL_Renderer* renderer = nullptr);
+
+    void setRenderer(SDL_Renderer* renderer);
+
+    /**
+     * Gives a texture a handle commands can refer to.
+     *
+     * @param texture The texture, may be replaced later with setTexture.
+     *
+     * @return The handle, or -1 once maxTextures are in use.
+     */
+    int addTexture(SDL_Texture* texture);
+
+    //points a handle at another texture, for one that is rebuilt, like the score text
+    void setTexture(int handle, SDL_Texture* texture);
+    SDL_Texture* getTexture(int handle) const;
+    //the handle of a texture added before, -1 if it wasn't
+    int findTexture(SDL_Texture* texture) const;
+
+    //makes room for this many commands, so a frame of that size never allocates
+    void reserve(size_t commands);
+
+    /**
+     * Records one draw.
+     *
+     * @param layer The RenderLayer to draw in.
+     * @param texture A handle from addTexture.
+     * @param src The pixels of the texture to draw.
+     * @param dst Where to draw them, scaled to fit.
+     * @param color The colour the texture is multiplied with, white draws it as it is.
+     */
+    void push(int layer, int texture, const Rect& src, const Rect& dst, SDL_Color color = { 255, 255, 255, 255 })
+    {
+        commands.push_back({ static_cast<uint16_t>((layer << 8) | texture), static_cast<uint16_t>(texture), src, dst, color });
+    }
+
+    //sorts the recorded commands by key, keeping the recording order of equal keys
+    void sort();
+
+    /**
+     * Sorts, draws and clears the recorded commands. Hands the frame to the recording first, if there is one.
+     *
+     * @param frame False for draws that aren't a displayed frame, like a cached layer being rebuilt,
+     *              so the recording keeps one frame per frame on screen.
+     *
+     * @return The SDL_RenderGeometry calls it took.
+     */
+    size_t submit(bool frame = true);
+
+    const std::vector<RenderCommand>& getCommands() const { return commands; }
+    void clear() { commands.clear(); }
+
+    //every submitted frame is added to this recording until it is set back to nullptr
+    void setRecording(RenderRecording* recording);
+
+private:
+    SDL_Renderer* renderer;
+    SpriteBatch batch;
+    std::vector<SDL_Texture*> textures;
+    std::vector<RenderCommand> commands;
+    //the radix sort's second buffer, swapped with commands every pass
+    std::vector<RenderCommand> sorted;
+    RenderRecording* recording = nullptr;
+};
+
+/*
+* submitted frames kept as commands, with the size of every texture handle,
+* so the render path can be benchmarked on real frames without running the game
+*/
+class RenderRecording
+{
+public:
+    //adds a frame, texture sizes are read from the queue's textures the first time a handle shows up
+    void addFrame(const std::vector<RenderCommand>& frameCommands, const RenderQueue& queue);
+
+    size_t getFrameCount() const { return frameStarts.size(); }
+
+    /**
+     * Pushes a recorded frame into a queue, in its recorded order.
+     *
+     * @param frame The frame, below getFrameCount.
+     * @param queue The queue to fill. Its handles must match the recording's, see getTextureSize.
+     */
+    void replayFrame(size_t frame, RenderQueue& queue) const;
+
+    //width and height of a texture handle's texture when it was recorded, 0 x 0 if it was never used
+    SDL_Point getTextureSize(int handle) const;
+    int getTextureCount() const { return static_cast<int>(textureSizes.size()); }
+
+    /**
+     * Writes the recording as little-endian binary.
+     *
+     * @param path The file to create or overwrite.
+     *
+     * @return true if the whole file was written, false otherwise.
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * Reads a recording written by save.
+     *
+     * @param path The file to read.
+     *
+     * @return true if the file was a whole recording, false otherwise.
+     */
+    bool load(const std::string& path);
+
+private:
+    std::vector<RenderCommand> commands;
+    //index of every frame's first command
+    std::vector<uint32_t> frameStarts;
+    std::vector<SDL_Point> textureSizes;
+};
+
+#endif
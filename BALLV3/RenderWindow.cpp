@@ -1,58 +1,267 @@
 #include "RenderWindow.h"
 #include "Entities.h"  
+#include "AssetArchive.h"
+#include "Profiler.h"
 
-RenderWindow::RenderWindow(const char* p_title, int p_w, int p_h) 
-    : window(NULL), renderer(NULL), wallTexture(NULL),
-    leftWall(0, 0, nullptr, 0.0f, 0.0f, false, INT_MAX),
-    rightWall(p_w - 50, 0, nullptr, 0.0f, 0.0f, false, INT_MAX) 
+#include <algorithm>
+
+namespace
+{
+    //past this share of the window, one full present beats many small ones
+    const double fullPresentShare = 0.5;
+}
+
+RenderWindow::RenderWindow(const char* p_title, int p_w, int p_h, bool p_software) 
+    : window(NULL), renderer(NULL), width(p_w), height(p_h), software(p_software)
 {
     window = SDL_CreateWindow(p_title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, p_w, p_h, SDL_WINDOW_SHOWN);
     if (window == NULL) {
         std::cout << "WINDOW ERROR: " << SDL_GetError() << std::endl;
     }
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-
-    wallTexture = loadTexture("wall.png");
-    if (!wallTexture) {
-        std::cout << "PROBLEM with WALL" << std::endl;
+    if (software) {
+        //drawing straight into the window surface keeps last frame's pixels for the dirty regions to build on
+        SDL_Surface* surface = window ? SDL_GetWindowSurface(window) : NULL;
+        renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+        if (renderer == NULL) {
+            std::cout << "SOFTWARE RENDERER ERROR: " << SDL_GetError() << std::endl;
+            software = false;
+        }
+    }
+    if (renderer == NULL) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     }
+    //a driver may ignore the vsync request, so ask what it gave
+    SDL_RendererInfo info;
+    vsync = renderer && SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+    queue.setRenderer(renderer);
+}
 
-    leftWall = Entity(0, 0, wallTexture, 0.0f, 0.0f, false, INT_MAX, true);
-    rightWall = Entity(p_w - 50, 0, wallTexture, 0.0f, 0.0f, false, INT_MAX, true);
+bool RenderWindow::buildAtlas()
+{
+    if (!atlas.isDirty()) {
+        return true;
+    }
+    const bool built = atlas.build(renderer);
+    for (size_t page = 0; page < atlas.getPageCount(); ++page) {
+        SDL_Texture* texture = atlas.getPage(static_cast<int>(page));
+        if (page < pageHandles.size()) {
+            queue.setTexture(pageHandles[page], texture);
+        }
+        else {
+            pageHandles.push_back(queue.addTexture(texture));
+        }
+    }
+    return built;
+}
 
-    leftWall.getCurrentFrame().h = p_h; 
-    rightWall.getCurrentFrame().h = p_h;
+const AtlasSprite& RenderWindow::getSprite(int p_texture)
+{
+    //images loaded since the last frame are packed in before anything is drawn from the atlas
+    buildAtlas();
+    return atlas.getSprite(p_texture);
+}
 
+int RenderWindow::frameTextureHandle(SDL_Texture* p_texture)
+{
+    for (size_t i = 0; i < frameHandlesUsed; ++i) {
+        if (queue.getTexture(frameHandles[i]) == p_texture) {
+            return frameHandles[i];
+        }
+    }
+    //the same handles every frame, so a texture rebuilt each score change never runs the queue out of them
+    if (frameHandlesUsed == frameHandles.size()) {
+        const int handle = queue.addTexture(p_texture);
+        if (handle < 0) {
+            return -1;
+        }
+        frameHandles.push_back(handle);
+    }
+    queue.setTexture(frameHandles[frameHandlesUsed], p_texture);
+    return frameHandles[frameHandlesUsed++];
 }
 
+bool RenderWindow::clipToWindow(SDL_Rect& p_rect) const
+{
+    const SDL_Rect bounds = { 0, 0, width, height };
+    return SDL_IntersectRect(&p_rect, &bounds, &p_rect) == SDL_TRUE;
+}
 
-void RenderWindow::addWalls(std::vector<Entity>& entities) const
+void RenderWindow::queueSprite(int p_layer, int p_texture, const Rect& p_frame, int p_x, int p_y, int p_w, int p_h)
 {
-    entities.insert(entities.begin(), leftWall);
-    entities.insert(entities.begin() + 1, rightWall);
+    const AtlasSprite& sprite = getSprite(p_texture);
+    if (sprite.page < 0 || sprite.page >= static_cast<int>(pageHandles.size()) || pageHandles[sprite.page] < 0) {
+        return;
+    }
+
+    //clipped to the image like SDL_RenderCopy clips to the texture, the destination keeps its size
+    Rect src = p_frame;
+    src.w = std::min(src.x + src.w, sprite.region.w) - src.x;
+    src.h = std::min(src.y + src.h, sprite.region.h) - src.y;
+    if (src.w <= 0 || src.h <= 0) {
+        return;
+    }
+    src.x += sprite.region.x;
+    src.y += sprite.region.y;
+
+    const Rect dst = { p_x, p_y, p_w, p_h };
+    queue.push(p_layer, pageHandles[sprite.page], src, dst);
 }
 
 void RenderWindow::render(Entity& p_entity)
 {
-    SDL_Rect src;
-    src.x = static_cast<int>(p_entity.getCurrentFrame().x);
-    src.y = static_cast<int>(p_entity.getCurrentFrame().y);
-    src.w = static_cast<int>(p_entity.getCurrentFrame().w);
-    src.h = static_cast<int>(p_entity.getCurrentFrame().h);
+    const Rect& frame = p_entity.getCurrentFrame();
+    queueSprite(LAYER_BODIES, p_entity.getTexture(), frame, static_cast<int>(p_entity.getX()), static_cast<int>(p_entity.getY()), frame.w, frame.h);
+}
+
+void RenderWindow::render(const Player& p_player)
+{
+    const Rect rect = p_player.getRect();
+    const AtlasSprite& sprite = getSprite(p_player.getTexture());
+    const Rect whole = { 0, 0, sprite.region.w, sprite.region.h };
+    queueSprite(LAYER_PLAYER, p_player.getTexture(), whole, rect.x, rect.y, rect.w, rect.h);
+}
 
-    SDL_Rect dst;
-    dst.x = static_cast<int>(p_entity.getX());
-    dst.y = static_cast<int>(p_entity.getY());
-    dst.w = p_entity.getCurrentFrame().w;
-    dst.h = p_entity.getCurrentFrame().h;
+void RenderWindow::render(const EntityRegistry& p_entities, float p_alpha)
+{
+    PROFILE_ZONE("render bodies");
+    const float* positionX = p_entities.getPositionsX();
+    const float* positionY = p_entities.getPositionsY();
+    const float* velocityX = p_entities.getVelocitiesX();
+    const float* velocityY = p_entities.getVelocitiesY();
 
-    SDL_RenderCopy(renderer, p_entity.getTexture(), &src, &dst);
+    queue.reserve(queue.getCommands().size() + p_entities.size());
+    for (size_t i = 0; i < p_entities.size(); ++i) {
+        const Rect& frame = p_entities.getCurrentFrame(i);
+        const float x = positionX[i] + velocityX[i] * p_alpha;
+        const float y = positionY[i] + velocityY[i] * p_alpha;
+        queueSprite(LAYER_BODIES, p_entities.getTexture(i), frame, static_cast<int>(x), static_cast<int>(y), frame.w, frame.h);
+    }
+}
+
+void RenderWindow::render(SDL_Texture* p_texture)
+{
+    int textureWidth = 0, textureHeight = 0;
+    const int handle = p_texture ? frameTextureHandle(p_texture) : -1;
+    if (handle < 0 || SDL_QueryTexture(p_texture, nullptr, nullptr, &textureWidth, &textureHeight) != 0) {
+        return;
+    }
+    queue.push(LAYER_BACKGROUND, handle, { 0, 0, textureWidth, textureHeight }, { 0, 0, width, height });
+}
+
+void RenderWindow::renderStatic(SDL_Texture* p_background, const EntityRegistry& p_entities)
+{
+    if (!staticLayer) {
+        staticLayer = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        if (!staticLayer) {
+            std::cout << "Could not create the static layer: " << SDL_GetError() << std::endl;
+        }
+        else {
+            staticHandle = queue.addTexture(staticLayer);
+            //copied as it is, it covers the whole window anyway
+            SDL_SetTextureBlendMode(staticLayer, SDL_BLENDMODE_NONE);
+        }
+    }
+    if (!staticLayer || staticHandle < 0) {
+        //no render targets, draw it all every frame
+        render(p_background);
+        render(p_entities);
+        return;
+    }
+
+    const bool stale = staticRebuilds == 0 || atlas.isDirty() || p_background != staticBackground
+        || &p_entities != staticEntities || p_entities.getLayoutVersion() != staticVersion;
+    if (stale) {
+        PROFILE_ZONE("static layer");
+        //whatever was recorded so far belongs on the screen, not in the layer
+        if (!queue.getCommands().empty()) {
+            flush();
+        }
+        SDL_SetRenderTarget(renderer, staticLayer);
+        SDL_RenderClear(renderer);
+        render(p_background);
+        render(p_entities);
+        //drawn into the layer, not a frame of its own, so a render recording doesn't count it
+        drawCalls += queue.submit(false);
+        frameHandlesUsed = 0;
+        SDL_SetRenderTarget(renderer, NULL);
+
+        staticBackground = p_background;
+        staticEntities = &p_entities;
+        staticVersion = p_entities.getLayoutVersion();
+        staticRebuilds++;
+        fullRedraw = true;
+    }
+
+    const Rect whole = { 0, 0, width, height };
+    if (software && !fullRedraw) {
+        //only what moved last frame needs the layer underneath put back
+        for (const SDL_Rect& rect : previousRects) {
+            const Rect region = { rect.x, rect.y, rect.w, rect.h };
+            queue.push(LAYER_BACKGROUND, staticHandle, region, region);
+        }
+    }
+    else {
+        queue.push(LAYER_BACKGROUND, staticHandle, whole, whole);
+    }
+    staticDrawn = true;
+}
+
+void RenderWindow::addDirtyRect(const SDL_Rect& p_rect)
+{
+    SDL_Rect rect = p_rect;
+    if (software && clipToWindow(rect)) {
+        dirtyRects.push_back(rect);
+    }
+}
+
+void RenderWindow::render(SDL_Texture* p_texture, int p_x, int p_y)
+{
+    int textureWidth = 0, textureHeight = 0;
+    const int handle = p_texture ? frameTextureHandle(p_texture) : -1;
+    if (handle < 0 || SDL_QueryTexture(p_texture, nullptr, nullptr, &textureWidth, &textureHeight) != 0) {
+        return;
+    }
+    queue.push(LAYER_UI, handle, { 0, 0, textureWidth, textureHeight }, { p_x, p_y, textureWidth, textureHeight });
+}
+
+void RenderWindow::renderText(GlyphAtlas& p_glyphs, const char* p_text, SDL_Color p_color, int p_x, int p_y)
+{
+    SDL_Texture* texture = p_glyphs.getTexture(renderer);
+    const int handle = texture ? frameTextureHandle(texture) : -1;
+    if (handle < 0) {
+        return;
+    }
+    p_glyphs.layout(p_text, p_x, p_y, [&](const Rect& src, const Rect& dst) {
+        queue.push(LAYER_UI, handle, src, dst, p_color);
+    });
+}
+
+void RenderWindow::flush()
+{
+    if (software) {
+        //everything above the background is drawn over the static layer and has to be repaired next frame
+        for (const RenderCommand& command : queue.getCommands()) {
+            SDL_Rect rect = { command.dst.x, command.dst.y, command.dst.w, command.dst.h };
+            if ((command.key >> 8) != LAYER_BACKGROUND && clipToWindow(rect)) {
+                dirtyRects.push_back(rect);
+            }
+        }
+    }
+    drawCalls += queue.submit();
+    frameHandlesUsed = 0;
 }
 
 SDL_Texture* RenderWindow::loadTexture(const char* p_filePath)
 {
     SDL_Texture* texture = NULL;
-    texture = IMG_LoadTexture(renderer, p_filePath);
+    SDL_Surface* packed = AssetArchive::Instance().loadImage(p_filePath);
+    if (packed) {
+        texture = SDL_CreateTextureFromSurface(renderer, packed);
+        SDL_FreeSurface(packed);
+    }
+    else {
+        texture = IMG_LoadTexture(renderer, p_filePath);
+    }
     if (texture == NULL)
     {
         std::cout << "MERDE TEXTURE : " << IMG_GetError() << std::endl;
@@ -60,18 +269,78 @@ SDL_Texture* RenderWindow::loadTexture(const char* p_filePath)
     }
     return texture;
 }
+
+bool RenderWindow::loadTexture(int p_id, const char* p_filePath, int p_packedWidth, int p_packedHeight)
+{
+    return atlas.add(p_id, p_filePath, p_packedWidth, p_packedHeight);
+}
+
+bool RenderWindow::loadTexture(int p_id, SDL_Surface* p_surface)
+{
+    return p_surface && atlas.add(p_id, p_surface);
+}
+
+SDL_Texture* RenderWindow::createTexture(SDL_Surface* p_surface)
+{
+    if (!p_surface) {
+        return NULL;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, p_surface);
+    SDL_FreeSurface(p_surface);
+    if (texture == NULL) {
+        std::cout << "MERDE TEXTURE : " << SDL_GetError() << std::endl;
+    }
+    return texture;
+}
+
 void RenderWindow::display()
 {
-    SDL_RenderPresent(renderer);
+    PROFILE_ZONE("display");
+    flush();
+    if (!software) {
+        SDL_RenderPresent(renderer);
+        return;
+    }
+
+    SDL_RenderFlush(renderer);
+    //what was drawn this frame, and what was drawn last frame and has just been painted over
+    presentRects.assign(previousRects.begin(), previousRects.end());
+    presentRects.insert(presentRects.end(), dirtyRects.begin(), dirtyRects.end());
+    double area = 0.0;
+    for (const SDL_Rect& rect : presentRects) {
+        area += static_cast<double>(rect.w) * rect.h;
+    }
+
+    if (fullRedraw || !staticDrawn || area > fullPresentShare * width * height) {
+        SDL_UpdateWindowSurface(window);
+    }
+    else if (!presentRects.empty()) {
+        SDL_UpdateWindowSurfaceRects(window, presentRects.data(), static_cast<int>(presentRects.size()));
+    }
+
+    previousRects.swap(dirtyRects);
+    dirtyRects.clear();
+    //a frame drawn without the static layer can't be repaired region by region
+    fullRedraw = !staticDrawn;
+    staticDrawn = false;
 }
 
 
 void RenderWindow::cleanUp()
 {
+    if (staticLayer) {
+        SDL_DestroyTexture(staticLayer);
+        staticLayer = nullptr;
+    }
+    atlas.cleanUp();
     SDL_DestroyWindow(window);
 }
 
 void RenderWindow::clear()
 {
-    SDL_RenderClear(renderer);
+    //the software renderer keeps last frame to draw the dirty regions over
+    if (!software) {
+        SDL_RenderClear(renderer);
+    }
+    drawCalls = 0;
 }
@@ -6,6 +6,12 @@
 #include <SDL_image.h>
 #include <iostream>
 #include "Entities.h"
+#include "EntityRegistry.h"
+#include "GlyphAtlas.h"
+#include "Player.h"
+#include "SimTypes.h"
+#include "SpriteAtlas.h"
+#include "RenderQueue.h"
 
 class RenderWindow
 {
@@ -19,14 +25,16 @@ public:
 	 * @param p_title A pointer to a C-string representing the title of the window.
 	 * @param p_w The width of the window in pixels.
 	 * @param p_h The height of the window in pixels.
+	 * @param p_software Draws with SDL's software renderer straight into the window surface and presents
+	 *                   only the regions that changed, for machines without a usable GPU.
 	 */
-	RenderWindow(const char* p_title, int p_w, int p_h);
+	RenderWindow(const char* p_title, int p_w, int p_h, bool p_software = false);
 
 	/**
 	 * Loads a texture from the specified file path.
 	 *
 	 * This function loads an image file and converts it into an SDL_Texture, which
-	 * can be used for rendering in the SDL context.
+	 * can be used for rendering in the SDL context. The asset archive's baked pixels are used when it has the image.
 	 *
 	 * @param p_filePath A pointer to a C-string representing the path to the image file.
 	 *
@@ -34,6 +42,46 @@ public:
 	 */
 	SDL_Texture* loadTexture(const char* p_filePath);
 
+	/**
+	 * Loads an image into the sprite atlas under a TextureId, so bodies carrying that ID are drawn with it.
+	 * The atlas is packed again before the next sprite is drawn.
+	 *
+	 * @param p_id The TextureId the simulation uses for this image.
+	 * @param p_filePath A pointer to a C-string representing the path to the image file.
+	 * @param p_packedWidth The width to keep the image at in the atlas, 0 for its own.
+	 * @param p_packedHeight The height to keep the image at in the atlas, 0 for its own.
+	 *
+	 * @return true if the image was loaded, false otherwise.
+	 */
+	bool loadTexture(int p_id, const char* p_filePath, int p_packedWidth = 0, int p_packedHeight = 0);
+
+	/**
+	 * Puts an image decoded elsewhere into the sprite atlas under a TextureId, see AssetLoader.
+	 *
+	 * @param p_id The TextureId the simulation uses for this image.
+	 * @param p_surface The image, prepared by SpriteAtlas::prepare. The atlas takes it over.
+	 *
+	 * @return true if the image was added, false otherwise.
+	 */
+	bool loadTexture(int p_id, SDL_Surface* p_surface);
+
+	/**
+	 * Uploads an image decoded elsewhere as a texture of its own, for a background for instance.
+	 *
+	 * @param p_surface The image, freed by the call.
+	 *
+	 * @return A pointer to the SDL_Texture object if the upload is successful, or nullptr if it fails.
+	 */
+	SDL_Texture* createTexture(SDL_Surface* p_surface);
+
+	/**
+	 * Packs the images loaded since the last build into the atlas and uploads its pages.
+	 * Drawing does it anyway, calling it while loading keeps the cost out of the first frame.
+	 *
+	 * @return true if every page was created, false otherwise.
+	 */
+	bool buildAtlas();
+
 	/**
 	 * Cleans up and frees resources associated with the SDL window and renderer.
 	 *
@@ -46,7 +94,8 @@ public:
 	 * Clears the current rendering target.
 	 *
 	 * This function resets the rendering target, preparing it for a new frame.
-	 * Typically used at the start of a rendering cycle.
+	 * Typically used at the start of a rendering cycle. Also restarts the draw call count.
+	 * With the software renderer the last frame is kept instead, renderStatic() repairs it.
 	 */
 	void clear();
 
@@ -54,20 +103,102 @@ public:
 	 * Renders an entity onto the screen.
 	 *
 	 * This function takes an `Entity` object and uses its position and texture
-	 * to draw it onto the rendering target.
+	 * to record it in the bodies layer. Nothing reaches the screen before the next flush().
 	 *
 	 * @param p_entity A reference to the `Entity` object to be rendered.
 	 */
 	void render(Entity& p_entity);
 
+	/**
+	 * Renders the player's sprite at the player's position, in the player layer above the bodies.
+	 *
+	 * @param p_player A reference to the `Player` to be rendered.
+	 */
+	void render(const Player& p_player);
+
+	/**
+	 * Renders every body stored in a registry.
+	 *
+	 * Only the position and velocity columns and the cold texture/frame data are read. All of them
+	 * are recorded in the bodies layer, so bodies on the same atlas page cost one draw call.
+	 *
+	 * @param p_entities A reference to the `EntityRegistry` whose bodies will be rendered.
+	 * @param p_alpha How far into the next simulation tick the frame is, FixedTimestep::getAlpha().
+	 *                Bodies are drawn that fraction of a tick further along their velocity, 0 draws them where they are.
+	 */
+	void render(const EntityRegistry& p_entities, float p_alpha = 0.0f);
+
 	/**
 	 * Displays the rendered content on the screen.
 	 *
 	 * This function presents the back buffer (the current rendering target) to the screen,
-	 * effectively updating the displayed image.
+	 * effectively updating the displayed image. Recorded draws are flushed first.
 	 */
 	void display();
 
+	//sorts and draws everything recorded since the last flush, call before drawing with the renderer directly
+	void flush();
+
+	/**
+	 * Renders a texture stretched over the whole window, in the background layer.
+	 *
+	 * @param p_texture The texture to draw, a background for instance.
+	 */
+	void render(SDL_Texture* p_texture);
+
+	/**
+	 * Renders the background and the bodies of a registry, the parts of a frame that stay put, from a cached layer.
+	 *
+	 * The layer is composited into a render target and only drawn again when the background changes
+	 * or the registry's layout version does: a wave shifting, a planet spawning or dying.
+	 * With the software renderer only the regions drawn over last frame are copied back from it.
+	 *
+	 * @param p_background The texture stretched over the whole window behind the bodies.
+	 * @param p_entities The resting bodies: planets and walls.
+	 */
+	void renderStatic(SDL_Texture* p_background, const EntityRegistry& p_entities);
+
+	/**
+	 * Adds a region drawn with the renderer directly, bypassing the render calls of this class,
+	 * so the software renderer presents it and repairs it next frame.
+	 *
+	 * @param p_rect The region, in window pixels. An empty one is ignored.
+	 */
+	void addDirtyRect(const SDL_Rect& p_rect);
+
+	//times the static layer was composited since the window opened
+	uint64_t getStaticRebuilds() const { return staticRebuilds; }
+
+	/**
+	 * Renders a texture at its own size in the UI layer, above everything else.
+	 *
+	 * @param p_texture The texture to draw, text for instance. Must live until the next flush().
+	 * @param p_x The x-coordinate of its top left corner.
+	 * @param p_y The y-coordinate of its top left corner.
+	 */
+	void render(SDL_Texture* p_texture, int p_x, int p_y);
+
+	/**
+	 * Renders a line of text from a glyph atlas in the UI layer, one quad per glyph and no texture of its own,
+	 * so the text of a frame is drawn along with the rest of its layer.
+	 *
+	 * @param p_glyphs The glyph atlas of the font, from FontManager::GetGlyphs.
+	 * @param p_text The text, a '\n' starts a new line. Only read during the call.
+	 * @param p_color The colour of the text.
+	 * @param p_x The x-coordinate of its top left corner.
+	 * @param p_y The y-coordinate of its top left corner.
+	 */
+	void renderText(GlyphAtlas& p_glyphs, const char* p_text, SDL_Color p_color, int p_x, int p_y);
+
+	//every flushed frame is added to this recording until it is set back to nullptr
+	void setRecording(RenderRecording* p_recording) { queue.setRecording(p_recording); }
+
+	//render calls since the last clear(), a flushed batch of sprites counting as one
+	size_t getDrawCalls() const { return drawCalls; }
+
+	//display() waits for the monitor's refresh, so the game loop doesn't need its own frame cap
+	bool isVsynced() const { return vsync; }
+
 	/**
 	 * Retrieves the SDL window associated with this object.
 	 *
@@ -88,25 +219,55 @@ public:
 	 */
 	SDL_Renderer* getRenderer() const { return renderer; }
 
-	/**
-	 * Adds wall entities to a provided vector for rendering and interaction.
-	 *
-	 * This function creates wall objects and appends them to the provided vector,
-	 * enabling their inclusion in the game world for rendering and collision detection.
-	 *
-	 * @param entities A reference to a vector of `Entity` objects to which the walls will be added.
-	 */
-	void addWalls(std::vector<Entity>& entities) const;
-
 
 private:
+	//the atlas entry of a TextureId, packing the atlas first if images were loaded since
+	const AtlasSprite& getSprite(int p_texture);
+
+	//records part of a sprite, p_frame is in the image's own pixels
+	void queueSprite(int p_layer, int p_texture, const Rect& p_frame, int p_x, int p_y, int p_w, int p_h);
+
+	//a queue handle for a texture outside the atlas, handed out again every frame
+	int frameTextureHandle(SDL_Texture* p_texture);
+
+	//p_rect clipped to the window, false if nothing is left
+	bool clipToWindow(SDL_Rect& p_rect) const;
+
 	SDL_Window* window;
 	SDL_Renderer* renderer;
 
-	SDL_Texture* wallTexture;
+	SpriteAtlas atlas;
+	RenderQueue queue;
+	//queue handles of the atlas pages, by page
+	std::vector<int> pageHandles;
+	//queue handles for other textures, the first frameHandlesUsed are taken this frame
+	std::vector<int> frameHandles;
+	size_t frameHandlesUsed = 0;
+
+	size_t drawCalls = 0;
+
+	int width;
+	int height;
+
+	//the background and the resting bodies, redrawn when what they were drawn from changes
+	SDL_Texture* staticLayer = nullptr;
+	int staticHandle = -1;
+	SDL_Texture* staticBackground = nullptr;
+	const EntityRegistry* staticEntities = nullptr;
+	uint32_t staticVersion = 0;
+	uint64_t staticRebuilds = 0;
+	//renderStatic ran this frame, the software renderer can present only the dirty regions
+	bool staticDrawn = false;
 
-	Entity leftWall;
-	Entity rightWall;
+	//draws into the window surface, presenting with SDL_UpdateWindowSurfaceRects
+	bool software;
+	bool vsync = false;
+	//the next present must cover the whole window
+	bool fullRedraw = true;
+	//regions drawn over the static layer this frame and the frame before
+	std::vector<SDL_Rect> dirtyRects;
+	std::vector<SDL_Rect> previousRects;
+	std::vector<SDL_Rect> presentRects;
 };
 
 #endif // !RENDERWINDOW_H
@@ -0,0 +1,320 @@
+#include "Replay.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+    const char magic[4] = { 'F', 'B', 'R', 'P' };
+    const uint8_t version = 1;
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool getVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            const uint8_t byte = in[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //small signed changes become small unsigned numbers: 0, -1, 1, -2 -> 0, 1, 2, 3
+    uint64_t zigzag(int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t unzigzag(uint64_t value)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(value >> 1) ^ (0u - static_cast<uint32_t>(value & 1)));
+    }
+
+    //shortest way around the circle, so aiming across 0 still costs one byte
+    int32_t aimDelta(uint16_t from, uint16_t to)
+    {
+        return static_cast<int16_t>(static_cast<uint16_t>(to - from));
+    }
+}
+
+//RECORDER
+
+ReplayRecorder::ReplayRecorder(const World& world, uint64_t keyframeInterval)
+    : seed(world.rng.getSeed()), windowWidth(world.windowWidth), windowHeight(world.windowHeight),
+    keyframeInterval(keyframeInterval), lastAimStep(world.player.getAimStep()),
+    lastShotsFired(world.player.getShotsFired()), length(world.tickCount)
+{
+    ReplayKeyframe start;
+    start.tick = world.tickCount;
+    start.aimStep = lastAimStep;
+    start.lastEventTick = world.tickCount;
+    start.checksum = world.checksum();
+    keyframes.push_back(start);
+    lastEventTick = world.tickCount;
+}
+
+void ReplayRecorder::writeEvent(uint64_t tick, ReplayEvent type)
+{
+    putVarint(events, (tick - lastEventTick) << 1 | type);
+    lastEventTick = tick;
+}
+
+void ReplayRecorder::writeAim(uint64_t tick, uint16_t aimStep)
+{
+    if (aimStep == lastAimStep) {
+        return;
+    }
+    writeEvent(tick, REPLAY_AIM);
+    putVarint(events, zigzag(aimDelta(lastAimStep, aimStep)));
+    lastAimStep = aimStep;
+}
+
+void ReplayRecorder::recordFire(const World& world)
+{
+    //the first projectile of the burst already left with this aim
+    writeAim(world.tickCount, world.player.getAimStep());
+    writeEvent(world.tickCount, REPLAY_FIRE);
+    lastShotsFired = world.player.getShotsFired();
+}
+
+void ReplayRecorder::recordStep(const World& world)
+{
+    const uint64_t tick = world.tickCount - 1;
+
+    //the aim only matters to the simulation when a projectile leaves with it
+    if (world.player.getShotsFired() != lastShotsFired) {
+        writeAim(tick, world.player.getAimStep());
+        lastShotsFired = world.player.getShotsFired();
+    }
+    length = world.tickCount;
+
+    if (world.tickCount % keyframeInterval == 0) {
+        ReplayKeyframe keyframe;
+        keyframe.tick = world.tickCount;
+        keyframe.offset = static_cast<uint32_t>(events.size());
+        keyframe.aimStep = lastAimStep;
+        keyframe.lastEventTick = lastEventTick;
+        keyframe.checksum = world.checksum();
+        keyframes.push_back(keyframe);
+    }
+}
+
+bool ReplayRecorder::save(const std::string& path) const
+{
+    std::vector<uint8_t> file(magic, magic + sizeof(magic));
+    file.push_back(version);
+    putVarint(file, seed);
+    putVarint(file, static_cast<uint64_t>(windowWidth));
+    putVarint(file, static_cast<uint64_t>(windowHeight));
+
+    putVarint(file, events.size());
+    file.insert(file.end(), events.begin(), events.end());
+
+    putVarint(file, length);
+    putVarint(file, keyframes.size());
+    const ReplayKeyframe* previous = nullptr;
+    for (const ReplayKeyframe& keyframe : keyframes) {
+        putVarint(file, keyframe.tick - (previous ? previous->tick : 0));
+        putVarint(file, keyframe.offset - (previous ? previous->offset : 0));
+        putVarint(file, keyframe.aimStep);
+        putVarint(file, keyframe.tick - keyframe.lastEventTick);
+        for (int i = 0; i < 8; ++i) {
+            file.push_back(static_cast<uint8_t>(keyframe.checksum >> (8 * i)));
+        }
+        previous = &keyframe;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!out) {
+        std::cerr << "Could not write replay " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+size_t ReplayRecorder::getEventBytes() const
+{
+    return events.size();
+}
+
+//PLAYER
+
+bool ReplayPlayer::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Could not open replay " << path << std::endl;
+        return false;
+    }
+    const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (file.size() < sizeof(magic) + 1 || !std::equal(magic, magic + sizeof(magic), file.begin()) || file[4] != version) {
+        std::cerr << path << " is not a replay" << std::endl;
+        return false;
+    }
+
+    size_t pos = sizeof(magic) + 1;
+    uint64_t width, height, eventBytes, keyframeCount;
+    bool ok = getVarint(file, pos, seed) && getVarint(file, pos, width) && getVarint(file, pos, height)
+        && getVarint(file, pos, eventBytes) && eventBytes <= file.size() - pos;
+    if (ok) {
+        events.assign(file.begin() + pos, file.begin() + pos + eventBytes);
+        pos += eventBytes;
+        ok = getVarint(file, pos, length) && getVarint(file, pos, keyframeCount) && keyframeCount > 0;
+    }
+
+    keyframes.clear();
+    for (uint64_t i = 0; ok && i < keyframeCount; ++i) {
+        uint64_t tickDelta, offsetDelta, aim, sinceEvent;
+        ok = getVarint(file, pos, tickDelta) && getVarint(file, pos, offsetDelta)
+            && getVarint(file, pos, aim) && getVarint(file, pos, sinceEvent) && pos + 8 <= file.size();
+        if (!ok) {
+            break;
+        }
+
+        ReplayKeyframe keyframe;
+        keyframe.tick = (keyframes.empty() ? 0 : keyframes.back().tick) + tickDelta;
+        keyframe.offset = static_cast<uint32_t>((keyframes.empty() ? 0 : keyframes.back().offset) + offsetDelta);
+        keyframe.aimStep = static_cast<uint16_t>(aim);
+        keyframe.lastEventTick = keyframe.tick - sinceEvent;
+        for (int b = 0; b < 8; ++b) {
+            keyframe.checksum |= static_cast<uint64_t>(file[pos++]) << (8 * b);
+        }
+        keyframes.push_back(keyframe);
+    }
+
+    if (!ok) {
+        std::cerr << path << " is truncated" << std::endl;
+        return false;
+    }
+    windowWidth = static_cast<int>(width);
+    windowHeight = static_cast<int>(height);
+    snapshots.clear();
+    snapshots.push_back(createWorld());
+    restart(keyframes.front());
+    return true;
+}
+
+World ReplayPlayer::createWorld() const
+{
+    return World(windowWidth, windowHeight, seed);
+}
+
+void ReplayPlayer::restart(const ReplayKeyframe& keyframe)
+{
+    cursor = keyframe.offset;
+    nextTick = keyframe.lastEventTick;
+    aimStep = keyframe.aimStep;
+    readEventHeader();
+}
+
+bool ReplayPlayer::readEventHeader()
+{
+    uint64_t header;
+    hasNext = getVarint(events, cursor, header);
+    if (hasNext) {
+        nextTick += header >> 1;
+        nextType = static_cast<ReplayEvent>(header & 1);
+    }
+    return hasNext;
+}
+
+void ReplayPlayer::applyInputs(World& world)
+{
+    while (hasNext && nextTick == world.tickCount) {
+        if (nextType == REPLAY_AIM) {
+            uint64_t delta;
+            if (!getVarint(events, cursor, delta)) {
+                hasNext = false;
+                break;
+            }
+            aimStep = static_cast<uint16_t>(aimStep + unzigzag(delta));
+            world.player.setAimStep(aimStep);
+        }
+        else {
+            world.player.setAimStep(aimStep);
+            Simulation::fire(world);
+        }
+        readEventHeader();
+    }
+}
+
+bool ReplayPlayer::verifyStep(const World& world) const
+{
+    auto keyframe = std::lower_bound(keyframes.begin(), keyframes.end(), world.tickCount,
+        [](const ReplayKeyframe& k, uint64_t tick) { return k.tick < tick; });
+    if (keyframe == keyframes.end() || keyframe->tick != world.tickCount) {
+        return true;
+    }
+    return keyframe->checksum == world.checksum();
+}
+
+size_t ReplayPlayer::latestSnapshot(uint64_t tick) const
+{
+    auto after = std::upper_bound(keyframes.begin(), keyframes.begin() + snapshots.size(), tick,
+        [](uint64_t t, const ReplayKeyframe& k) { return t < k.tick; });
+    return static_cast<size_t>(after - keyframes.begin()) - 1;
+}
+
+bool ReplayPlayer::seek(World& world, uint64_t tick)
+{
+    tick = std::min(tick, length);
+
+    //snapshot 0 is the fresh world, so there is always one at or before the tick
+    const size_t snapshot = latestSnapshot(tick);
+    if (tick < world.tickCount || keyframes[snapshot].tick > world.tickCount) {
+        world = snapshots[snapshot];
+        restart(keyframes[snapshot]);
+    }
+
+    while (world.tickCount < tick) {
+        applyInputs(world);
+        const bool running = Simulation::step(world);
+        if (!verifyStep(world)) {
+            return false;
+        }
+
+        if (snapshots.size() < keyframes.size() && keyframes[snapshots.size()].tick == world.tickCount) {
+            snapshots.push_back(world);
+        }
+        if (!running) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool ReplayPlayer::isFinished(const World& world) const
+{
+    return world.tickCount >= length;
+}
+
+uint64_t ReplayPlayer::getSeed() const
+{
+    return seed;
+}
+
+uint64_t ReplayPlayer::getLength() const
+{
+    return length;
+}
+
+const std::vector<ReplayKeyframe>& ReplayPlayer::getKeyframes() const
+{
+    return keyframes;
+}
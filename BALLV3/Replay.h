@@ -0,0 +1,171 @@
+#pragma once
+#ifndef Replay_h
+#define Replay_h
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "World.h"
+
+/*
+* a replay is the world seed plus the inputs the simulation actually saw, stamped with the tick they
+* were applied before: bursts started (SPACE) and the aim whenever a shot used a new one
+*
+* file layout, every integer an unsigned LEB128 varint unless noted:
+*   "FBRP" version(byte) seed width height
+*   eventBytes events[eventBytes]
+*   length keyframeCount keyframes[keyframeCount]
+* an event is (tickDelta << 1 | type), an AIM event is followed by the zigzagged change of the aim step
+* a keyframe is tickDelta offsetDelta aimStep checksum(8 bytes, little endian)
+*/
+
+enum ReplayEvent : uint8_t
+{
+    REPLAY_FIRE = 0,
+    REPLAY_AIM = 1
+};
+
+//decoder state at a tick, enough to start reading events from there
+struct ReplayKeyframe
+{
+    uint64_t tick = 0;
+    uint32_t offset = 0;
+    uint16_t aimStep = 0;
+    uint64_t lastEventTick = 0;
+    //World::checksum after the tick before this one, to catch a desync
+    uint64_t checksum = 0;
+};
+
+class ReplayRecorder
+{
+public:
+    /**
+     * Starts an empty recording of the given world, which should not have stepped yet.
+     *
+     * @param world The world being played, its seed and size go in the header.
+     * @param keyframeInterval Ticks between keyframes.
+     */
+    explicit ReplayRecorder(const World& world, uint64_t keyframeInterval = 256);
+
+    /**
+     * Records a burst started with Simulation::fire. Call it after fire returned true,
+     * before the next Simulation::step.
+     *
+     * @param world The world that fired.
+     */
+    void recordFire(const World& world);
+
+    /**
+     * Records the aim of a tick if a shot used it, and drops a keyframe when one is due.
+     * Call it after every Simulation::step.
+     *
+     * @param world The world that just stepped.
+     */
+    void recordStep(const World& world);
+
+    /**
+     * Writes the recording to a file.
+     *
+     * @param path The file to create or overwrite.
+     *
+     * @return true if the whole file was written, false otherwise.
+     */
+    bool save(const std::string& path) const;
+
+    //bytes of encoded events so far
+    size_t getEventBytes() const;
+
+private:
+    void writeEvent(uint64_t tick, ReplayEvent type);
+    void writeAim(uint64_t tick, uint16_t aimStep);
+
+    uint64_t seed;
+    int windowWidth, windowHeight;
+    uint64_t keyframeInterval;
+
+    std::vector<uint8_t> events;
+    std::vector<ReplayKeyframe> keyframes;
+    uint64_t lastEventTick = 0;
+    uint16_t lastAimStep;
+    uint32_t lastShotsFired = 0;
+    uint64_t length = 0;
+};
+
+class ReplayPlayer
+{
+public:
+    /**
+     * Reads a replay file.
+     *
+     * @param path The file to read.
+     *
+     * @return true if the file was read and is a replay this version understands, false otherwise.
+     */
+    bool load(const std::string& path);
+
+    //the world the replay starts from
+    World createWorld() const;
+
+    /**
+     * Applies the inputs recorded for the world's current tick: aim changes and bursts.
+     * Call it before every Simulation::step.
+     *
+     * @param world The world being replayed.
+     */
+    void applyInputs(World& world);
+
+    /**
+     * Checks the world against the keyframe of the tick that just ran, if there is one.
+     * Call it after every Simulation::step.
+     *
+     * @param world The world being replayed.
+     *
+     * @return false if the world no longer matches the recording, true otherwise.
+     */
+    bool verifyStep(const World& world) const;
+
+    /**
+     * Moves a replay to the given tick. Every keyframe it passes is kept as a world snapshot,
+     * so it starts from the latest snapshot at or before the tick when that is ahead of the world
+     * or the tick is behind it, and replays the rest as fast as possible.
+     *
+     * @param world The world being replayed. It is replaced by a copy of the snapshot it starts from.
+     * @param tick The tick to stop at, clamped to the length of the replay.
+     *
+     * @return false if the world desynced on the way, true otherwise.
+     */
+    bool seek(World& world, uint64_t tick);
+
+    //true once every recorded tick has been played
+    bool isFinished(const World& world) const;
+
+    uint64_t getSeed() const;
+    uint64_t getLength() const;
+    const std::vector<ReplayKeyframe>& getKeyframes() const;
+
+private:
+    //positions the decoder at a keyframe
+    void restart(const ReplayKeyframe& keyframe);
+    bool readEventHeader();
+
+    //index of the latest snapshot at or before the tick
+    size_t latestSnapshot(uint64_t tick) const;
+
+    uint64_t seed = 0;
+    int windowWidth = 0, windowHeight = 0;
+    uint64_t length = 0;
+    std::vector<uint8_t> events;
+    std::vector<ReplayKeyframe> keyframes;
+    //the world at keyframes[i].tick, filled in order as seek verifies each keyframe
+    std::vector<World> snapshots;
+
+    //decoder
+    size_t cursor = 0;
+    uint64_t nextTick = 0;
+    ReplayEvent nextType = REPLAY_FIRE;
+    bool hasNext = false;
+    uint16_t aimStep = 0;
+};
+
+#endif
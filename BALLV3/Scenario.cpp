@@ -0,0 +1,279 @@
+#include "Scenario.h"
+#include "Simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace
+{
+    const int windowWidth = 620;
+    const int windowHeight = 840;
+    const double pi = 3.14159265358979;
+    //a volley spreads over a quarter turn around the aim
+    const double volleyFan = pi / 2.0;
+
+    //nearest-rank percentile of sorted times
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+    }
+
+    void checkBudget(std::vector<std::string>& overBudget, const char* what, double value, double budget, const char* unit)
+    {
+        if (budget > 0.0 && value > budget) {
+            std::ostringstream line;
+            line << what << " " << value << " " << unit << " over the budget of " << budget << " " << unit;
+            overBudget.push_back(line.str());
+        }
+    }
+}
+
+//FILE
+
+bool Scenario::loadFile(const std::string& path, std::vector<Scenario>& scenarios)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open scenario file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream words(line);
+        std::string key, value;
+        if (!(words >> key)) {
+            continue;
+        }
+        if (!(words >> value)) {
+            std::cerr << path << ":" << lineNumber << ": " << key << " needs a value" << std::endl;
+            return false;
+        }
+
+        if (key == "scenario") {
+            scenarios.push_back(Scenario());
+            scenarios.back().name = value;
+            continue;
+        }
+        if (scenarios.empty()) {
+            std::cerr << path << ":" << lineNumber << ": " << key << " before the first scenario line" << std::endl;
+            return false;
+        }
+
+        Scenario& scenario = scenarios.back();
+        const double number = atof(value.c_str());
+        if (key == "seed") scenario.seed = strtoull(value.c_str(), nullptr, 10);
+        else if (key == "ticks") scenario.ticks = strtoull(value.c_str(), nullptr, 10);
+        else if (key == "wave") scenario.wave = static_cast<int>(number);
+        else if (key == "planets") scenario.planets = static_cast<int>(number);
+        else if (key == "projectiles") scenario.projectiles = static_cast<int>(number);
+        else if (key == "projectile-tilt") scenario.projectileTilt = static_cast<float>(number);
+        else if (key == "bot") scenario.bot = number != 0.0;
+        else if (key == "volley") scenario.volley = static_cast<int>(number);
+        else if (key == "volley-ms") scenario.volleyMs = number;
+        else if (key == "stop-on-game-over") scenario.stopOnGameOver = number != 0.0;
+        else if (key == "wave-size") scenario.params.firstWaveSize = static_cast<int>(number);
+        else if (key == "health") scenario.params.firstEntityHealth = static_cast<int>(number);
+        else if (key == "ramp") scenario.params.wavesPerRamp = std::max(1, static_cast<int>(number));
+        else if (key == "burst") scenario.params.firstMaxProjectiles = static_cast<int>(number);
+        else if (key == "level-points") scenario.params.pointsPerLevel = static_cast<int>(number);
+        else if (key == "gravity") scenario.params.gravityStrength = static_cast<float>(number);
+        else if (key == "projectile-speed") scenario.params.projectileSpeed = static_cast<int>(number);
+        else if (key == "budget-p50-ms") scenario.budgetP50Ms = number;
+        else if (key == "budget-p95-ms") scenario.budgetP95Ms = number;
+        else if (key == "budget-p99-ms") scenario.budgetP99Ms = number;
+        else if (key == "budget-max-ms") scenario.budgetMaxMs = number;
+        else if (key == "budget-memory-mb") scenario.budgetMemoryMb = number;
+        else {
+            std::cerr << path << ":" << lineNumber << ": unknown key " << key << std::endl;
+            return false;
+        }
+    }
+
+    if (scenarios.empty()) {
+        std::cerr << path << " has no scenario" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//RUN
+
+ScenarioRun::ScenarioRun(const Scenario& scenario)
+    : scenario(scenario), world(windowWidth, windowHeight, scenario.seed, scenario.params), bot(~scenario.seed)
+{
+    //the same ramp Entity::Spawn applies after every wave
+    SpawnState& spawn = world.spawn;
+    for (int wave = 0; wave < scenario.wave; ++wave) {
+        if (spawn.placeholder % spawn.wavesPerRamp == 0) {
+            spawn.entitiesToSpawn++;
+            spawn.entityHealth++;
+        }
+        spawn.placeholder++;
+    }
+
+    Random& rng = world.rng;
+    world.entities.ensureHeadroom(scenario.planets);
+    world.broadphase.reserve(world.entities.size() + scenario.planets);
+    for (int i = 0; i < scenario.planets; ++i) {
+        const float x = std::floor(rng.nextFloat() * (windowWidth - 128));
+        const float y = 64.0f + std::floor(rng.nextFloat() * (windowHeight - 128));
+        world.entities.add(Entity(x, y, TEXTURE_PLANET1 + i % planetTextureCount, 0.0f, 0.0f, false, spawn.entityHealth));
+    }
+
+    world.projectiles.ensureHeadroom(scenario.projectiles);
+    const float speed = static_cast<float>(scenario.params.projectileSpeed);
+    for (int i = 0; i < scenario.projectiles; ++i) {
+        const float x = 50.0f + rng.nextFloat() * (windowWidth - 132);
+        const float y = 128.0f + rng.nextFloat() * (windowHeight - 256);
+        const float tilt = static_cast<float>((2.0f * rng.nextFloat() - 1.0f) * scenario.projectileTilt * pi / 180.0);
+        const float direction = rng.nextFloat() < 0.5f ? -1.0f : 1.0f;
+        world.projectiles.add(Entity(x, y, TEXTURE_PROJECTILE, direction * speed * std::cos(tilt), speed * std::sin(tilt), true));
+    }
+
+    tickMs.reserve(static_cast<size_t>(scenario.ticks));
+}
+
+bool ScenarioRun::tick()
+{
+    if (finished) {
+        return false;
+    }
+
+    if (scenario.bot) {
+        bot.play(world);
+    }
+    const double gameMs = world.tickCount * Simulation::tickSeconds * 1000.0;
+    while (scenario.volley > 0 && scenario.volleyMs > 0.0 && gameMs >= volleysFired * scenario.volleyMs) {
+        fireVolley();
+        volleysFired++;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    const bool running = Simulation::step(world);
+    tickMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+    finished = world.tickCount >= scenario.ticks || (!running && scenario.stopOnGameOver);
+    return !finished;
+}
+
+void ScenarioRun::fireVolley()
+{
+    //from where Player::fireProjectile fires, at the same whole-pixel speeds
+    const Rect player = world.player.getRect();
+    const float originX = static_cast<float>(player.x + player.w / 2 - 15);
+    const float originY = static_cast<float>(player.y + player.h / 2);
+    const double aim = world.player.getAimAngle();
+    const int speed = world.params.projectileSpeed;
+
+    world.projectiles.ensureHeadroom(scenario.volley);
+    for (int i = 0; i < scenario.volley; ++i) {
+        const double spread = scenario.volley > 1 ? static_cast<double>(i) / (scenario.volley - 1) - 0.5 : 0.0;
+        const double angle = aim + spread * volleyFan;
+        const int velocityX = static_cast<int>(speed * std::cos(angle));
+        const int velocityY = static_cast<int>(speed * std::sin(angle));
+        world.projectiles.add(Entity(originX, originY, TEXTURE_PROJECTILE,
+            static_cast<float>(velocityX), static_cast<float>(velocityY), true));
+    }
+}
+
+bool ScenarioRun::isFinished() const
+{
+    return finished;
+}
+
+ScenarioResult ScenarioRun::getResult() const
+{
+    ScenarioResult result;
+    result.name = scenario.name;
+    result.ticks = tickMs.size();
+    result.score = world.player.getScore();
+    result.bodiesAtEnd = world.entities.size() + world.projectiles.size();
+
+    std::vector<double> sorted(tickMs);
+    std::sort(sorted.begin(), sorted.end());
+    result.p50Ms = percentile(sorted, 0.50);
+    result.p95Ms = percentile(sorted, 0.95);
+    result.p99Ms = percentile(sorted, 0.99);
+    result.maxMs = sorted.empty() ? 0.0 : sorted.back();
+    double total = 0.0;
+    for (double ms : sorted) {
+        total += ms;
+    }
+    result.meanMs = sorted.empty() ? 0.0 : total / sorted.size();
+    result.peakMemoryMb = peakMemoryBytes() / (1024.0 * 1024.0);
+
+    checkBudget(result.overBudget, "p50", result.p50Ms, scenario.budgetP50Ms, "ms");
+    checkBudget(result.overBudget, "p95", result.p95Ms, scenario.budgetP95Ms, "ms");
+    checkBudget(result.overBudget, "p99", result.p99Ms, scenario.budgetP99Ms, "ms");
+    checkBudget(result.overBudget, "max", result.maxMs, scenario.budgetMaxMs, "ms");
+    if (result.peakMemoryMb > 0.0) {
+        checkBudget(result.overBudget, "peak memory", result.peakMemoryMb, scenario.budgetMemoryMb, "MB");
+    }
+    return result;
+}
+
+World& ScenarioRun::getWorld()
+{
+    return world;
+}
+
+const Scenario& ScenarioRun::getScenario() const
+{
+    return scenario;
+}
+
+void ScenarioRun::resetPeakMemory()
+{
+#if defined(__linux__)
+    //5 resets VmHWM to the current resident size
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+size_t ScenarioRun::peakMemoryBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+        }
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
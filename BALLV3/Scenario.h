@@ -0,0 +1,138 @@
+#pragma once
+#ifndef Scenario_h
+#define Scenario_h
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "World.h"
+#include "AimBot.h"
+
+/*
+* scripted stress scenes for the whole game loop
+*
+* a scenario file is plain text, one "key value" per line, # starts a comment,
+* and every "scenario NAME" line starts a new scene:
+*
+*   scenario wave200
+*   ticks 640
+*   wave 200
+*   planets 5000
+*   budget-p99-ms 4
+*
+* the keys are listed in Scenario::loadFile, times are in milliseconds and memory in megabytes
+*/
+
+//one stress scene
+struct Scenario
+{
+    std::string name;
+    uint64_t seed = 1;
+    //simulation ticks to run, at Simulation::ticksPerSecond
+    uint64_t ticks = 320;
+    GameParams params;
+
+    //waves already played before the first tick, so wave size and planet health start ramped up
+    int wave = 0;
+    //planets placed over the playfield before the first tick
+    int planets = 0;
+    //projectiles placed between the walls before the first tick, flying sideways
+    int projectiles = 0;
+    //the most the starting projectiles lean away from horizontal, in degrees
+    float projectileTilt = 0.0f;
+
+    //an AimBot aims at the highest planet and holds SPACE
+    bool bot = true;
+    //every volleyMs, volley projectiles leave the player at once, fanned around the aim
+    int volley = 0;
+    double volleyMs = 0.0;
+    //stress scenes keep going after the game-over line is crossed unless this is set
+    bool stopOnGameOver = false;
+
+    //limits the run is checked against, 0 leaves one unchecked
+    double budgetP50Ms = 0.0;
+    double budgetP95Ms = 0.0;
+    double budgetP99Ms = 0.0;
+    double budgetMaxMs = 0.0;
+    double budgetMemoryMb = 0.0;
+
+    /**
+     * Reads every scenario of a scenario file.
+     *
+     * Keys: seed, ticks, wave, planets, projectiles, projectile-tilt, bot (0 or 1), volley, volley-ms,
+     * stop-on-game-over (0 or 1), wave-size, health, ramp, burst, level-points, gravity, projectile-speed,
+     * budget-p50-ms, budget-p95-ms, budget-p99-ms, budget-max-ms and budget-memory-mb.
+     *
+     * @param path The file to read.
+     * @param scenarios Filled with the scenarios of the file, in order.
+     *
+     * @return true if the whole file was understood, false otherwise. Errors are printed with their line.
+     */
+    static bool loadFile(const std::string& path, std::vector<Scenario>& scenarios);
+};
+
+struct ScenarioResult
+{
+    std::string name;
+    uint64_t ticks = 0;
+    //time of one Simulation::step
+    double p50Ms = 0.0, p95Ms = 0.0, p99Ms = 0.0, maxMs = 0.0, meanMs = 0.0;
+    //peak resident memory of the process during the run, 0 where the platform can't tell
+    double peakMemoryMb = 0.0;
+    int score = 0;
+    size_t bodiesAtEnd = 0;
+    //one line per budget the run went over
+    std::vector<std::string> overBudget;
+};
+
+/*
+* plays one scenario tick by tick, so the headless runner can loop it flat out
+* and the game can render it between ticks
+*/
+class ScenarioRun
+{
+public:
+    /**
+     * Builds the scenario's world: waves fast-forwarded, planets and projectiles placed.
+     * Call resetPeakMemory first to measure the run on its own.
+     *
+     * @param scenario The scene to play.
+     */
+    explicit ScenarioRun(const Scenario& scenario);
+
+    /**
+     * Applies the scripted inputs of the tick and runs one timed Simulation::step.
+     * The tick's events are in getWorld().events.
+     *
+     * @return false once the scenario is over, true otherwise.
+     */
+    bool tick();
+
+    bool isFinished() const;
+
+    //tick-time percentiles, peak memory and the budgets the run went over
+    ScenarioResult getResult() const;
+
+    World& getWorld();
+    const Scenario& getScenario() const;
+
+    //restarts the peak memory count where the platform allows it (Linux), otherwise the peak covers the whole process
+    static void resetPeakMemory();
+    //peak resident memory of the process in bytes, 0 if unknown
+    static size_t peakMemoryBytes();
+
+private:
+    void fireVolley();
+
+    Scenario scenario;
+    World world;
+    AimBot bot;
+
+    std::vector<double> tickMs;
+    bool finished = false;
+    //volleys are due every volleyMs of game time, counted in ticks so they repeat exactly
+    uint64_t volleysFired = 0;
+};
+
+#endif
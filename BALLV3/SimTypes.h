@@ -0,0 +1,33 @@
+#pragma once
+#ifndef SimTypes_h
+#define SimTypes_h
+
+/*
+* plain types shared by the simulation and the SDL front end,
+* so nothing under the simulation has to include SDL
+*/
+
+//integer rectangle, same layout and meaning as SDL_Rect
+struct Rect
+{
+    int x, y, w, h;
+};
+
+//textures are referred to by ID in the simulation, RenderWindow maps them to SDL_Texture
+enum TextureId
+{
+    TEXTURE_NONE = -1,
+    TEXTURE_PLAYER = 0,
+    TEXTURE_PROJECTILE,
+    TEXTURE_WALL,
+    TEXTURE_PLANET1,
+    TEXTURE_PLANET2,
+    TEXTURE_PLANET3,
+    TEXTURE_PLANET4,
+    TEXTURE_PLANET5,
+    TEXTURE_COUNT
+};
+
+const int planetTextureCount = 5;
+
+#endif
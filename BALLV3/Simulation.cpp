@@ -0,0 +1,61 @@
+#include "Simulation.h"
+#include "Collisions.h"
+#include "Entities.h"
+#include "Profiler.h"
+
+const double Simulation::ticksPerSecond = 32.0;
+const double Simulation::tickSeconds = 1.0 / Simulation::ticksPerSecond;
+
+bool Simulation::step(World& world)
+{
+    PROFILE_ZONE("Simulation::step");
+    world.events.clear();
+    Player::outOfBounds(world.projectiles, world.windowWidth, world.windowHeight, &world.isOutOfBounds, world.events);
+
+    //entity gets one of the 5 planet textures
+    //selection loops after every 5 spawns.
+    int chosenTexture = TEXTURE_PLANET1 + world.spawnCounter % planetTextureCount;
+    Entity::Spawn(world.entities, world.rng, world.spawn, chosenTexture, world.windowWidth, world.windowHeight, &world.isOutOfBounds);
+    world.spawnCounter++;
+
+    world.player.updateBurst(world.projectiles, TEXTURE_PROJECTILE, world.params.projectileSpeed, tickSeconds);
+
+    //apply gravity on the projectile
+    Collisions::applyGravity(world.projectiles, world.params.gravityStrength);
+
+    //move the projectiles, sweeping them against the entities so fast ones can't tunnel through
+    Collisions::checkCollisions(world.entities, world.projectiles, world.broadphase, world.events);
+
+    //everything killed this tick goes at once
+    world.entities.flushRemovals();
+    world.projectiles.flushRemovals();
+
+    //scoring drains the kills, a point each, levelling up on the way as if they had been scored one by one
+    for (uint32_t kill = world.events.count(EVENT_KILL); kill > 0; --kill) {
+        world.player.incrementScore(world.events);
+    }
+
+    world.tickCount++;
+    if (isGameOver(world)) {
+        world.events.push(EVENT_GAME_OVER);
+        return false;
+    }
+    return true;
+}
+
+bool Simulation::fire(World& world)
+{
+    return world.player.shoot(world.projectiles, TEXTURE_PROJECTILE, world.params.projectileSpeed);
+}
+
+bool Simulation::isGameOver(const World& world)
+{
+    const float* entityY = world.entities.getPositionsY();
+    const uint8_t* entityFlags = world.entities.getFlags();
+    for (size_t i = 0; i < world.entities.size(); ++i) {
+        if (entityY[i] <= -48 && !(entityFlags[i] & (ENTITY_PROJECTILE | ENTITY_WALL))) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef Simulation_h
+#define Simulation_h
+
+#include "World.h"
+
+/*
+* one fixed tick of game logic: out-of-bounds, spawning, bursts, gravity, collisions and the game-over check
+* the same sequence the game loop used to run inline, so the game and the headless runner can't drift apart
+* what happened in the tick is left in world.events for the game's sound and HUD to read, a headless run ignores it
+*/
+class Simulation
+{
+public:
+    //simulation rate, every per-tick speed in the game is tuned for 32
+    static const double ticksPerSecond;
+    static const double tickSeconds;
+
+    /**
+     * Advances a world by one tick.
+     *
+     * @param world The world to advance. Its events are cleared first, then hold the hits, kills,
+     *              lost projectiles, level-ups and game over of this tick.
+     *
+     * @return false once the game is over, true otherwise.
+     */
+    static bool step(World& world);
+
+    /**
+     * Starts a burst from the player, same as pressing SPACE.
+     *
+     * @param world The world whose player fires.
+     *
+     * @return true if a burst was started, false if the last one is still firing.
+     */
+    static bool fire(World& world);
+
+    /**
+     * Checks whether a planet has been pushed past the top of the playfield.
+     *
+     * @param world The world to check.
+     *
+     * @return true if the game is over, false otherwise.
+     */
+    static bool isGameOver(const World& world);
+};
+
+#endif
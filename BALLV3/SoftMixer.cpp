@@ -0,0 +1,421 @@
+#include "SoftMixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MIXER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//gcc and clang only emit AVX instructions in functions that ask for them, msvc emits them anywhere
+#if defined(MIXER_X86) && !defined(_MSC_VER)
+#define MIXER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MIXER_TARGET(isa)
+#endif
+
+namespace
+{
+    enum MixPath
+    {
+        MIX_SCALAR,
+        MIX_SSE2,
+        MIX_AVX2
+    };
+
+    //out[i] += in[i] * gain, gains alternating left and right, from an even index
+    void accumulateScalar(float* out, const int16_t* in, size_t count, float gainLeft, float gainRight)
+    {
+        for (size_t i = 0; i + 1 < count; i += 2) {
+            out[i] += in[i] * gainLeft;
+            out[i + 1] += in[i + 1] * gainRight;
+        }
+    }
+
+    void convertScalar(int16_t* out, const float* in, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            const float sample = std::min(std::max(in[i], -32768.0f), 32767.0f);
+            out[i] = static_cast<int16_t>(std::lrint(sample));
+        }
+    }
+
+#if defined(MIXER_X86)
+    MIXER_TARGET("sse2")
+    void accumulateSse2(float* out, const int16_t* in, size_t count, float gainLeft, float gainRight)
+    {
+        const __m128 gain = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            //sse2 has no sign extension: each sample goes to the top half of a lane and is shifted back down
+            const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+            const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_cvtepi32_ps(low), gain)));
+            _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_loadu_ps(out + i + 4), _mm_mul_ps(_mm_cvtepi32_ps(high), gain)));
+        }
+        accumulateScalar(out + i, in + i, count - i, gainLeft, gainRight);
+    }
+
+    MIXER_TARGET("sse2")
+    void convertSse2(int16_t* out, const float* in, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            //packs saturates to 16 bits, no clamp needed
+            const __m128i low = _mm_cvtps_epi32(_mm_loadu_ps(in + i));
+            const __m128i high = _mm_cvtps_epi32(_mm_loadu_ps(in + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(low, high));
+        }
+        convertScalar(out + i, in + i, count - i);
+    }
+
+    MIXER_TARGET("avx2")
+    void accumulateAvx2(float* out, const int16_t* in, size_t count, float gainLeft, float gainRight)
+    {
+        const __m256 gain = _mm256_setr_ps(gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight, gainLeft, gainRight);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m256 low = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+            const __m256 high = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8))));
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(low, gain)));
+            _mm256_storeu_ps(out + i + 8, _mm256_add_ps(_mm256_loadu_ps(out + i + 8), _mm256_mul_ps(high, gain)));
+        }
+        accumulateSse2(out + i, in + i, count - i, gainLeft, gainRight);
+    }
+
+    MIXER_TARGET("avx2")
+    void convertAvx2(int16_t* out, const float* in, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            const __m256i low = _mm256_cvtps_epi32(_mm256_loadu_ps(in + i));
+            const __m256i high = _mm256_cvtps_epi32(_mm256_loadu_ps(in + i + 8));
+            //packs works within each 128-bit half, the permute puts the four quarters back in order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+        }
+        convertSse2(out + i, in + i, count - i);
+    }
+#endif
+
+    MixPath detectPath()
+    {
+#if defined(MIXER_X86)
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = (info[3] & (1 << 26)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        bool avx2 = false;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+        //the OS has to save the ymm registers too, not just the CPU support them
+        if (avx2 && (xcr0 & 0x6) == 0x6) {
+            return MIX_AVX2;
+        }
+        if (sse2) {
+            return MIX_SSE2;
+        }
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return MIX_AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return MIX_SSE2;
+        }
+#endif
+#endif
+        return MIX_SCALAR;
+    }
+
+    const MixPath mixPath = detectPath();
+
+    void accumulate(float* out, const int16_t* in, size_t count, float gainLeft, float gainRight)
+    {
+#if defined(MIXER_X86)
+        if (mixPath == MIX_AVX2) {
+            accumulateAvx2(out, in, count, gainLeft, gainRight);
+            return;
+        }
+        if (mixPath == MIX_SSE2) {
+            accumulateSse2(out, in, count, gainLeft, gainRight);
+            return;
+        }
+#endif
+        accumulateScalar(out, in, count, gainLeft, gainRight);
+    }
+
+    void convert(int16_t* out, const float* in, size_t count)
+    {
+#if defined(MIXER_X86)
+        if (mixPath == MIX_AVX2) {
+            convertAvx2(out, in, count);
+            return;
+        }
+        if (mixPath == MIX_SSE2) {
+            convertSse2(out, in, count);
+            return;
+        }
+#endif
+        convertScalar(out, in, count);
+    }
+}
+
+SoftMixer::~SoftMixer()
+{
+    close();
+}
+
+bool SoftMixer::open(int frequency, int frames)
+{
+    close();
+
+    SDL_AudioSpec desired = {};
+    desired.freq = frequency;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = static_cast<Uint16>(frames);
+    desired.callback = &SoftMixer::callback;
+    desired.userdata = this;
+    //SDL converts to whatever the hardware wants, only the buffer size may change
+    SDL_AudioSpec obtained;
+    device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+    if (device == 0) {
+        std::cerr << "Could not open the mixer's audio device: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    bufferFrames = obtained.samples;
+    bufferTicks = SDL_GetPerformanceFrequency() * bufferFrames / frequency;
+    mixBuffer.assign(static_cast<size_t>(bufferFrames) * 2, 0.0f);
+    lastCallbackStart = 0;
+    SDL_PauseAudioDevice(device, 0);
+    return true;
+}
+
+void SoftMixer::close()
+{
+    if (device == 0) {
+        return;
+    }
+    SDL_CloseAudioDevice(device);
+    device = 0;
+    for (int voice = 0; voice < maxVoices; ++voice) {
+        voices[voice].active = false;
+        finished[voice].store(issued[voice], std::memory_order_relaxed);
+    }
+    Command command;
+    while (commands.pop(command)) {
+    }
+}
+
+void SoftMixer::setSound(int sound, const Mix_Chunk* chunk)
+{
+    if (sound < 0 || sound >= maxSounds) {
+        return;
+    }
+    Sound replacement;
+    if (chunk) {
+        replacement.samples = reinterpret_cast<const int16_t*>(chunk->abuf);
+        replacement.frames = chunk->alen / (2 * sizeof(int16_t));
+    }
+
+    if (device) {
+        SDL_LockAudioDevice(device);
+    }
+    //the old samples may be freed as soon as this returns
+    for (int voice = 0; voice < maxVoices; ++voice) {
+        if (voices[voice].active && voices[voice].samples == sounds[sound].samples) {
+            finish(voice);
+        }
+    }
+    sounds[sound] = replacement;
+    if (device) {
+        SDL_UnlockAudioDevice(device);
+    }
+}
+
+bool SoftMixer::play(int voice, int sound, float gain, float pan)
+{
+    if (voice < 0 || voice >= maxVoices || sound < 0 || sound >= maxSounds) {
+        return false;
+    }
+    pan = std::min(std::max(pan, -1.0f), 1.0f);
+
+    Command command;
+    command.type = COMMAND_PLAY;
+    command.voice = static_cast<uint8_t>(voice);
+    command.sound = static_cast<uint8_t>(sound);
+    command.generation = issued[voice] + 1;
+    //centred is full gain on both sides, like SDL_mixer without panning
+    command.gainLeft = gain * std::min(1.0f, 1.0f - pan);
+    command.gainRight = gain * std::min(1.0f, 1.0f + pan);
+    if (!commands.push(command)) {
+        droppedCommands++;
+        return false;
+    }
+    issued[voice] = command.generation;
+    return true;
+}
+
+bool SoftMixer::isPlaying(int voice) const
+{
+    return voice >= 0 && voice < maxVoices && finished[voice].load(std::memory_order_acquire) != issued[voice];
+}
+
+int SoftMixer::getVoicesPlaying() const
+{
+    int playing = 0;
+    for (int voice = 0; voice < maxVoices; ++voice) {
+        playing += isPlaying(voice) ? 1 : 0;
+    }
+    return playing;
+}
+
+void SoftMixer::stopAll()
+{
+    if (device) {
+        SDL_LockAudioDevice(device);
+    }
+    //the callback is held off, so this thread may stand in as the ring's consumer
+    Command command;
+    while (commands.pop(command)) {
+    }
+    for (int voice = 0; voice < maxVoices; ++voice) {
+        voices[voice].active = false;
+        finished[voice].store(issued[voice], std::memory_order_release);
+    }
+    if (device) {
+        SDL_UnlockAudioDevice(device);
+    }
+}
+
+MixerStats SoftMixer::getStats() const
+{
+    MixerStats stats;
+    const double microsecondsPerTick = 1000000.0 / SDL_GetPerformanceFrequency();
+    stats.bufferFrames = bufferFrames;
+    stats.callbacks = callbacks.load(std::memory_order_relaxed);
+    stats.underruns = underruns.load(std::memory_order_relaxed);
+    stats.lastCallbackUs = lastTicks.load(std::memory_order_relaxed) * microsecondsPerTick;
+    stats.peakCallbackUs = peakTicks.load(std::memory_order_relaxed) * microsecondsPerTick;
+    if (stats.callbacks > 0 && bufferTicks > 0) {
+        stats.load = static_cast<double>(totalTicks.load(std::memory_order_relaxed)) / (stats.callbacks * bufferTicks);
+    }
+    stats.droppedCommands = droppedCommands;
+    return stats;
+}
+
+void SoftMixer::report(std::ostream& out) const
+{
+    const MixerStats stats = getStats();
+    char line[200];
+    snprintf(line, sizeof(line), "mixer (%s, %d frames): %llu callbacks, last %.1f us, peak %.1f us, load %.2f%%, %llu underruns, %llu dropped plays\n",
+        getPathName(), stats.bufferFrames, static_cast<unsigned long long>(stats.callbacks), stats.lastCallbackUs,
+        stats.peakCallbackUs, stats.load * 100.0, static_cast<unsigned long long>(stats.underruns),
+        static_cast<unsigned long long>(stats.droppedCommands));
+    out << line;
+}
+
+const char* SoftMixer::getPathName()
+{
+    switch (mixPath) {
+    case MIX_SSE2: return "sse2";
+    case MIX_AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+void SDLCALL SoftMixer::callback(void* userdata, Uint8* stream, int length)
+{
+    static_cast<SoftMixer*>(userdata)->mix(reinterpret_cast<int16_t*>(stream), length / static_cast<int>(2 * sizeof(int16_t)));
+}
+
+void SoftMixer::mix(int16_t* out, int frames)
+{
+    const uint64_t start = SDL_GetPerformanceCounter();
+    //a buffer that starts more than two buffers after the last one, the device ran dry in between
+    if (lastCallbackStart != 0 && start - lastCallbackStart > 2 * bufferTicks) {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastCallbackStart = start;
+
+    Command command;
+    while (commands.pop(command)) {
+        apply(command);
+    }
+
+    //SDL asks for the buffer size it opened with, slices keep a larger request within mixBuffer
+    const int sliceFrames = std::max(1, bufferFrames);
+    for (int done = 0; done < frames; done += sliceFrames) {
+        const int slice = std::min(sliceFrames, frames - done);
+        const size_t count = static_cast<size_t>(slice) * 2;
+        std::fill(mixBuffer.begin(), mixBuffer.begin() + count, 0.0f);
+
+        for (int index = 0; index < maxVoices; ++index) {
+            Voice& voice = voices[index];
+            if (!voice.active) {
+                continue;
+            }
+            const uint32_t remaining = voice.frames - voice.position;
+            const uint32_t mixed = std::min(remaining, static_cast<uint32_t>(slice));
+            accumulate(mixBuffer.data(), voice.samples + static_cast<size_t>(voice.position) * 2, static_cast<size_t>(mixed) * 2,
+                voice.gainLeft, voice.gainRight);
+            voice.position += mixed;
+            if (voice.position >= voice.frames) {
+                finish(index);
+            }
+        }
+        convert(out + static_cast<size_t>(done) * 2, mixBuffer.data(), count);
+    }
+
+    const uint64_t elapsed = SDL_GetPerformanceCounter() - start;
+    //longer than the buffer lasts, the next one can't be ready in time
+    if (elapsed > bufferTicks) {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    lastTicks.store(elapsed, std::memory_order_relaxed);
+    if (elapsed > peakTicks.load(std::memory_order_relaxed)) {
+        peakTicks.store(elapsed, std::memory_order_relaxed);
+    }
+    totalTicks.fetch_add(elapsed, std::memory_order_relaxed);
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SoftMixer::apply(const Command& command)
+{
+    if (command.type != COMMAND_PLAY) {
+        return;
+    }
+    Voice& voice = voices[command.voice];
+    const Sound& sound = sounds[command.sound];
+    voice.samples = sound.samples;
+    voice.frames = sound.frames;
+    voice.position = 0;
+    voice.gainLeft = command.gainLeft;
+    voice.gainRight = command.gainRight;
+    voice.generation = command.generation;
+    voice.active = true;
+    if (!voice.samples || voice.frames == 0) {
+        finish(command.voice);
+    }
+}
+
+void SoftMixer::finish(int voice)
+{
+    voices[voice].active = false;
+    finished[voice].store(voices[voice].generation, std::memory_order_release);
+}
@@ -0,0 +1,177 @@
+#pragma once
+#ifndef SoftMixer_h
+#define SoftMixer_h
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "SpscRing.h"
+
+/*
+* an optional sound effect mixer that runs in its own SDL audio device's callback, with a short buffer
+*
+* SDL_mixer opens the device with Audio::chunkSize samples, about 46 ms at 44.1 kHz, so a hit is heard
+* well after the impact. This device runs 256 samples, under 6 ms, and mixes the decoded chunks itself:
+* 16-bit stereo samples, scaled by a left and right gain into a float buffer, 4 or 8 samples at a time
+* with SSE2 or AVX2, whichever the CPU has, then saturated back to 16 bits
+* the game thread never touches the voices: play sends a command through an SpscRing the callback
+* drains at its start, and learns a voice is done from a counter the callback publishes
+* SDL_mixer keeps the music, only the effects move here
+*
+*     SoftMixer mixer;
+*     mixer.open(44100, 256);
+*     mixer.setSound(0, hitChunk);
+*     mixer.play(3, 0, 0.8f);           //voice 3, sound 0
+*/
+
+struct MixerStats
+{
+    int bufferFrames = 0;
+    //time spent mixing in the latest callback and in the slowest one, in microseconds
+    double lastCallbackUs = 0.0;
+    double peakCallbackUs = 0.0;
+    //mixing time over the playing time of the buffers mixed, 1 means the callback only just keeps up
+    double load = 0.0;
+    uint64_t callbacks = 0;
+    //callbacks that came too late, or took too long, to have the device's buffer filled in time
+    uint64_t underruns = 0;
+    //plays dropped because the command ring was full
+    uint64_t droppedCommands = 0;
+};
+
+class SoftMixer
+{
+public:
+    static const int maxVoices = 32;
+    static const int maxSounds = 16;
+
+    SoftMixer() = default;
+    //closes the device
+    ~SoftMixer();
+
+    SoftMixer(const SoftMixer&) = delete;
+    SoftMixer& operator=(const SoftMixer&) = delete;
+
+    /**
+     * Opens an audio device of its own, 16-bit stereo, and starts the callback.
+     *
+     * @param frequency The sample rate the sounds were decoded at.
+     * @param bufferFrames Samples per channel the device asks for in a callback, 256 is under 6 ms at 44.1 kHz.
+     *
+     * @return true if the device is playing, false otherwise.
+     */
+    bool open(int frequency, int bufferFrames = 256);
+
+    //stops the callback and closes the device
+    void close();
+
+    bool isOpen() const { return device != 0; }
+
+    /**
+     * Sets the samples of a sound, stopping any voice still playing the sound's old ones.
+     * Waits for the callback, so only between games, not every frame.
+     *
+     * @param sound The sound's id, from 0 to maxSounds - 1.
+     * @param chunk 16-bit stereo samples at the device's frequency, kept by the caller. nullptr silences it.
+     */
+    void setSound(int sound, const Mix_Chunk* chunk);
+
+    /**
+     * Starts a sound on a voice, cutting off what the voice played before. Never blocks.
+     *
+     * @param voice The voice, from 0 to maxVoices - 1.
+     * @param sound The sound's id.
+     * @param gain 1 plays the samples as they are.
+     * @param pan -1 for the left speaker only, 1 for the right only, 0 for both at full gain.
+     *
+     * @return false if the command ring was full and the play was dropped, true otherwise.
+     */
+    bool play(int voice, int sound, float gain, float pan = 0.0f);
+
+    //true from play until the callback has played the voice to its end, or cut it off
+    bool isPlaying(int voice) const;
+    int getVoicesPlaying() const;
+
+    //stops every voice and drops the commands not read yet, waiting for the callback, before chunks are freed
+    void stopAll();
+
+    MixerStats getStats() const;
+
+    /**
+     * Writes the stats in one line, with the SIMD path in use.
+     *
+     * @param out The stream to write to, std::cout for instance.
+     */
+    void report(std::ostream& out) const;
+
+    //"avx2", "sse2" or "scalar"
+    static const char* getPathName();
+
+private:
+    enum CommandType : uint8_t
+    {
+        COMMAND_PLAY
+    };
+
+    struct Command
+    {
+        CommandType type;
+        uint8_t voice;
+        uint8_t sound;
+        uint32_t generation;
+        float gainLeft;
+        float gainRight;
+    };
+
+    struct Sound
+    {
+        const int16_t* samples = nullptr;
+        uint32_t frames = 0;
+    };
+
+    struct Voice
+    {
+        const int16_t* samples = nullptr;
+        uint32_t frames = 0;
+        uint32_t position = 0;
+        float gainLeft = 0.0f;
+        float gainRight = 0.0f;
+        uint32_t generation = 0;
+        bool active = false;
+    };
+
+    static void SDLCALL callback(void* userdata, Uint8* stream, int length);
+    //everything below runs on the audio thread
+    void mix(int16_t* out, int frames);
+    void apply(const Command& command);
+    void finish(int voice);
+
+    SDL_AudioDeviceID device = 0;
+    int bufferFrames = 0;
+    uint64_t bufferTicks = 0;
+
+    //changed under SDL_LockAudioDevice only
+    Sound sounds[maxSounds];
+
+    SpscRing<Command, 256> commands;
+    //the game thread's count of plays per voice, and the latest of them the callback finished
+    uint32_t issued[maxVoices] = {};
+    std::atomic<uint32_t> finished[maxVoices] = {};
+    uint64_t droppedCommands = 0;
+
+    //audio thread only
+    Voice voices[maxVoices];
+    std::vector<float> mixBuffer;
+    uint64_t lastCallbackStart = 0;
+
+    std::atomic<uint64_t> callbacks{ 0 };
+    std::atomic<uint64_t> underruns{ 0 };
+    std::atomic<uint64_t> lastTicks{ 0 };
+    std::atomic<uint64_t> peakTicks{ 0 };
+    std::atomic<uint64_t> totalTicks{ 0 };
+};
+
+#endif
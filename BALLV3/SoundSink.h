@@ -0,0 +1,40 @@
+#pragma once
+#ifndef SoundSink_h
+#define SoundSink_h
+
+#include "GameEvents.h"
+
+/*
+* the sounds the game plays for the simulation's events
+* Audio plays them through SDL_mixer, a headless run simply has no sink
+*/
+class SoundSink
+{
+public:
+    virtual ~SoundSink() = default;
+
+    virtual void playHitSound() = 0;
+    virtual void playDeathSound() = 0;
+    virtual void playLevelUpSound() = 0;
+    virtual void playGameOver() = 0;
+
+    //the audio consumer of a tick's events, a sound per event
+    void playEvents(const GameEventBuffer& events)
+    {
+        for (uint32_t i = events.count(EVENT_HIT); i > 0; --i) {
+            playHitSound();
+        }
+        //the game over sound doubles as the kill sound, the death screen plays it for the end of the game
+        for (uint32_t i = events.count(EVENT_KILL); i > 0; --i) {
+            playGameOver();
+        }
+        for (uint32_t i = events.count(EVENT_PROJECTILE_LOST); i > 0; --i) {
+            playDeathSound();
+        }
+        for (uint32_t i = events.count(EVENT_LEVEL_UP); i > 0; --i) {
+            playLevelUpSound();
+        }
+    }
+};
+
+#endif
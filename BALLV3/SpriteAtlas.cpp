@@ -0,0 +1,228 @@
+#include "SpriteAtlas.h"
+
+#include <SDL_image.h>
+#include <algorithm>
+#include <iostream>
+
+#include "AssetArchive.h"
+
+namespace
+{
+    //clear pixels around every sprite, so filtering never picks up a neighbour
+    const int padding = 1;
+
+    const AtlasSprite noSprite;
+
+    struct Placement
+    {
+        size_t image;
+        int page;
+        int x, y;
+    };
+}
+
+SpriteAtlas::SpriteAtlas(int pageSize)
+    : pageSize(pageSize)
+{
+}
+
+SpriteAtlas::~SpriteAtlas()
+{
+    cleanUp();
+}
+
+bool SpriteAtlas::add(int id, const char* path, int packedWidth, int packedHeight)
+{
+    if (id < 0 || id >= TEXTURE_COUNT) {
+        std::cout << "No texture ID " << id << " for " << path << std::endl;
+        return false;
+    }
+
+    //baked pixels when the asset archive has them, the only work left is the page blit
+    SDL_Surface* loaded = AssetArchive::Instance().loadImage(path);
+    if (!loaded) {
+        loaded = IMG_Load(path);
+    }
+    if (!loaded) {
+        std::cout << "MERDE TEXTURE : " << IMG_GetError() << std::endl;
+        return false;
+    }
+    SDL_Surface* surface = prepare(loaded, packedWidth, packedHeight);
+    if (!surface) {
+        std::cout << "Could not convert " << path << ": " << SDL_GetError() << std::endl;
+        return false;
+    }
+    return add(id, surface);
+}
+
+bool SpriteAtlas::add(int id, SDL_Surface* surface)
+{
+    if (id < 0 || id >= TEXTURE_COUNT) {
+        std::cout << "No texture ID " << id << std::endl;
+        SDL_FreeSurface(surface);
+        return false;
+    }
+
+    for (Image& image : images) {
+        if (image.id == id) {
+            SDL_FreeSurface(image.surface);
+            image.surface = surface;
+            dirty = true;
+            return true;
+        }
+    }
+    images.push_back({ id, surface });
+    dirty = true;
+    return true;
+}
+
+SDL_Surface* SpriteAtlas::prepare(SDL_Surface* loaded, int packedWidth, int packedHeight)
+{
+    //one pixel format for every image, so they blit into a page as they are
+    SDL_Surface* surface = loaded;
+    if (loaded->format->format != SDL_PIXELFORMAT_RGBA32) {
+        surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if (!surface) {
+            return nullptr;
+        }
+    }
+
+    const int width = packedWidth > 0 ? packedWidth : surface->w;
+    const int height = packedHeight > 0 ? packedHeight : surface->h;
+    if (width != surface->w || height != surface->h) {
+        SDL_Surface* scaled = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+        if (!scaled || SDL_BlitScaled(surface, nullptr, scaled, nullptr) != 0) {
+            SDL_FreeSurface(scaled);
+            SDL_FreeSurface(surface);
+            return nullptr;
+        }
+        SDL_FreeSurface(surface);
+        surface = scaled;
+    }
+    return surface;
+}
+
+bool SpriteAtlas::build(SDL_Renderer* renderer)
+{
+    for (SDL_Texture* page : pages) {
+        SDL_DestroyTexture(page);
+    }
+    pages.clear();
+    for (AtlasSprite& sprite : sprites) {
+        sprite = AtlasSprite();
+    }
+    dirty = false;
+
+    //tallest first, so each shelf wastes little height
+    std::vector<size_t> order(images.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return images[a].surface->h > images[b].surface->h;
+    });
+
+    std::vector<Placement> placements;
+    std::vector<SDL_Point> pageSizes;
+    //the page shelves are filled on, -1 until the first one is opened
+    int shelfPage = -1;
+    int shelfX = 0, shelfY = 0, shelfHeight = 0;
+    for (size_t i : order) {
+        const int width = images[i].surface->w + 2 * padding;
+        const int height = images[i].surface->h + 2 * padding;
+
+        //too big for any page, it gets one to itself
+        if (width > pageSize || height > pageSize) {
+            placements.push_back({ i, static_cast<int>(pageSizes.size()), padding, padding });
+            pageSizes.push_back({ width, height });
+            continue;
+        }
+
+        if (shelfPage >= 0 && shelfX + width > pageSize) {
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (shelfPage < 0 || shelfY + height > pageSize) {
+            shelfPage = static_cast<int>(pageSizes.size());
+            pageSizes.push_back({ pageSize, pageSize });
+            shelfX = shelfY = shelfHeight = 0;
+        }
+        placements.push_back({ i, shelfPage, shelfX + padding, shelfY + padding });
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+
+    bool built = true;
+    for (size_t page = 0; page < pageSizes.size(); ++page) {
+        SDL_Surface* pixels = SDL_CreateRGBSurfaceWithFormat(0, pageSizes[page].x, pageSizes[page].y, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!pixels) {
+            std::cout << "Could not create atlas page: " << SDL_GetError() << std::endl;
+            built = false;
+            pages.push_back(nullptr);
+            continue;
+        }
+        SDL_FillRect(pixels, nullptr, SDL_MapRGBA(pixels->format, 0, 0, 0, 0));
+
+        for (const Placement& placement : placements) {
+            if (placement.page != static_cast<int>(page)) {
+                continue;
+            }
+            const Image& image = images[placement.image];
+            SDL_Rect dst = { placement.x, placement.y, image.surface->w, image.surface->h };
+            //copy alpha as it is instead of blending onto the clear page
+            SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(image.surface, nullptr, pixels, &dst);
+
+            AtlasSprite& sprite = sprites[image.id];
+            sprite.page = static_cast<int>(page);
+            sprite.region = { dst.x, dst.y, image.surface->w, image.surface->h };
+        }
+
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, pixels);
+        SDL_FreeSurface(pixels);
+        if (!texture) {
+            std::cout << "Could not upload atlas page: " << SDL_GetError() << std::endl;
+            built = false;
+        }
+        else {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        }
+        pages.push_back(texture);
+    }
+    return built;
+}
+
+const AtlasSprite& SpriteAtlas::getSprite(int id) const
+{
+    if (id < 0 || id >= TEXTURE_COUNT) {
+        return noSprite;
+    }
+    return sprites[id];
+}
+
+SDL_Texture* SpriteAtlas::getPage(int page) const
+{
+    if (page < 0 || page >= static_cast<int>(pages.size())) {
+        return nullptr;
+    }
+    return pages[page];
+}
+
+void SpriteAtlas::cleanUp()
+{
+    for (SDL_Texture* page : pages) {
+        SDL_DestroyTexture(page);
+    }
+    pages.clear();
+    for (Image& image : images) {
+        SDL_FreeSurface(image.surface);
+    }
+    images.clear();
+    for (AtlasSprite& sprite : sprites) {
+        sprite = AtlasSprite();
+    }
+    dirty = false;
+}
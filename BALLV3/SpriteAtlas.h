@@ -0,0 +1,109 @@
+#pragma once
+#ifndef SpriteAtlas_h
+#define SpriteAtlas_h
+#include <SDL.h>
+#include <vector>
+
+#include "SimTypes.h"
+
+/*
+* packs the sprite images into a few large textures, the pages, when the game loads
+*
+* every sprite of a page can then be drawn in one SpriteBatch call instead of one
+* SDL_RenderCopy each with a texture switch in between
+* images are packed in shelves, tallest first, with a pixel of clear padding around each
+*/
+
+//where a sprite ended up
+struct AtlasSprite
+{
+    //-1 until the atlas is built with the sprite in it
+    int page = -1;
+    //the sprite's pixels in its page
+    Rect region = { 0, 0, 0, 0 };
+};
+
+class SpriteAtlas
+{
+public:
+    /**
+     * @param pageSize Width and height of a page. An image bigger than that gets a page of its own.
+     */
+    explicit SpriteAtlas(int pageSize = 1024);
+    ~SpriteAtlas();
+
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    /**
+     * Loads an image to be packed under an ID, from the asset archive when it has it. Takes effect at the next build().
+     *
+     * @param id The TextureId bodies carrying this image use, replaces an earlier image with the same ID.
+     * @param path The image file.
+     * @param packedWidth The width to pack the image at, 0 keeps its own. For images always drawn
+     *                    much smaller than they are, like the 1024 px player sprite.
+     * @param packedHeight The height to pack the image at, 0 keeps its own.
+     *
+     * @return true if the image was loaded, false otherwise.
+     */
+    bool add(int id, const char* path, int packedWidth = 0, int packedHeight = 0);
+
+    /**
+     * Adds an image already loaded and prepared, by the AssetLoader for instance. Takes effect at the next build().
+     *
+     * @param id The TextureId bodies carrying this image use, replaces an earlier image with the same ID.
+     * @param surface An image from prepare(), the atlas takes it over.
+     *
+     * @return true if the image was added, false if the ID is out of range and the surface was freed.
+     */
+    bool add(int id, SDL_Surface* surface);
+
+    /**
+     * Converts a loaded image to the atlas' pixel format and size. Touches nothing but the surface,
+     * so it can run on any thread.
+     *
+     * @param loaded The image as loaded, freed by the call.
+     * @param packedWidth The width to pack the image at, 0 keeps its own.
+     * @param packedHeight The height to pack the image at, 0 keeps its own.
+     *
+     * @return The image ready for add(), or nullptr if the conversion failed.
+     */
+    static SDL_Surface* prepare(SDL_Surface* loaded, int packedWidth = 0, int packedHeight = 0);
+
+    /**
+     * Packs every image added so far and uploads the pages, replacing the previous ones.
+     *
+     * @param renderer The renderer the pages are created for.
+     *
+     * @return true if every page was created, false otherwise.
+     */
+    bool build(SDL_Renderer* renderer);
+
+    //true when images were added since the last build
+    bool isDirty() const { return dirty; }
+
+    //the sprite packed under a TextureId, with page -1 if there is none
+    const AtlasSprite& getSprite(int id) const;
+
+    size_t getPageCount() const { return pages.size(); }
+    SDL_Texture* getPage(int page) const;
+
+    //destroys the pages and the loaded images
+    void cleanUp();
+
+private:
+    struct Image
+    {
+        int id;
+        SDL_Surface* surface;
+    };
+
+    int pageSize;
+    bool dirty = false;
+    std::vector<Image> images;
+    std::vector<SDL_Texture*> pages;
+    //indexed by TextureId
+    AtlasSprite sprites[TEXTURE_COUNT];
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "SpriteBatch.h"
+
+#include <iostream>
+
+namespace
+{
+    void growIndices(std::vector<int>& indices, size_t quads)
+    {
+        for (size_t quad = indices.size() / 6; quad < quads; ++quad) {
+            const int first = static_cast<int>(quad * 4);
+            //top left, top right, bottom left, then bottom left, top right, bottom right
+            const int pattern[6] = { first, first + 1, first + 2, first + 2, first + 1, first + 3 };
+            indices.insert(indices.end(), pattern, pattern + 6);
+        }
+    }
+}
+
+SpriteBatch::SpriteBatch(SDL_Renderer* renderer)
+    : renderer(renderer)
+{
+}
+
+void SpriteBatch::setRenderer(SDL_Renderer* p_renderer)
+{
+    flush();
+    renderer = p_renderer;
+}
+
+void SpriteBatch::reserve(size_t quads)
+{
+    vertices.reserve(quads * 4);
+    indices.reserve(quads * 6);
+    growIndices(indices, quads);
+}
+
+void SpriteBatch::draw(SDL_Texture* p_texture, const Rect& src, const SDL_FRect& dst, SDL_Color color)
+{
+    if (p_texture != texture) {
+        flush();
+        texture = p_texture;
+        int width = 1, height = 1;
+        if (texture) {
+            SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+        }
+        inverseWidth = 1.0f / width;
+        inverseHeight = 1.0f / height;
+    }
+
+    const float left = src.x * inverseWidth;
+    const float top = src.y * inverseHeight;
+    const float right = (src.x + src.w) * inverseWidth;
+    const float bottom = (src.y + src.h) * inverseHeight;
+
+    vertices.push_back({ { dst.x, dst.y }, color, { left, top } });
+    vertices.push_back({ { dst.x + dst.w, dst.y }, color, { right, top } });
+    vertices.push_back({ { dst.x, dst.y + dst.h }, color, { left, bottom } });
+    vertices.push_back({ { dst.x + dst.w, dst.y + dst.h }, color, { right, bottom } });
+}
+
+void SpriteBatch::flush()
+{
+    if (vertices.empty()) {
+        return;
+    }
+
+    const size_t quads = vertices.size() / 4;
+    growIndices(indices, quads);
+    if (SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()),
+        indices.data(), static_cast<int>(quads * 6)) != 0) {
+        std::cout << "SDL_RenderGeometry failed: " << SDL_GetError() << std::endl;
+    }
+    drawCalls++;
+    vertices.clear();
+}
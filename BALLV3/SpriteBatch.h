@@ -0,0 +1,58 @@
+#pragma once
+#ifndef SpriteBatch_h
+#define SpriteBatch_h
+#include <SDL.h>
+#include <vector>
+
+#include "SimTypes.h"
+
+/*
+* collects textured quads and hands every run of quads on the same texture
+* to SDL_RenderGeometry at once
+*
+* quads keep their order: drawing from another texture first submits what is queued,
+* so with one atlas page a whole frame of sprites is one call
+*/
+class SpriteBatch
+{
+public:
+    explicit SpriteBatch(SDL_Renderer* renderer = nullptr);
+
+    void setRenderer(SDL_Renderer* renderer);
+
+    //makes room for this many quads, so a frame of that size never allocates
+    void reserve(size_t quads);
+
+    /**
+     * Queues one quad.
+     *
+     * @param texture The texture the quad samples, an atlas page.
+     * @param src The pixels to sample, in texture coordinates.
+     * @param dst Where to draw them, in window coordinates.
+     * @param color The colour the texture is multiplied with, white draws it as it is.
+     */
+    void draw(SDL_Texture* texture, const Rect& src, const SDL_FRect& dst, SDL_Color color = { 255, 255, 255, 255 });
+
+    //submits the queued quads, call before drawing anything that isn't batched
+    void flush();
+
+    //SDL_RenderGeometry calls since the last resetDrawCalls
+    size_t getDrawCalls() const { return drawCalls; }
+    void resetDrawCalls() { drawCalls = 0; }
+
+    //quads waiting for the next flush
+    size_t getQueued() const { return vertices.size() / 4; }
+
+private:
+    SDL_Renderer* renderer;
+    SDL_Texture* texture = nullptr;
+    float inverseWidth = 0.0f;
+    float inverseHeight = 0.0f;
+
+    std::vector<SDL_Vertex> vertices;
+    //two triangles per quad, the same pattern every time, so only grown and never rewritten
+    std::vector<int> indices;
+    size_t drawCalls = 0;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#ifndef SpscRing_h
+#define SpscRing_h
+#include <atomic>
+#include <cstddef>
+
+/*
+* a fixed ring for one producer thread and one consumer thread, no locks and no allocation
+*
+* the producer only writes head and the consumer only writes tail, each on its own cache line,
+* so neither ever waits on the other: push fails when the ring is full, pop when it is empty
+* used to send commands into the audio callback, which must never block on the game thread
+*/
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+
+public:
+    //producer only
+    bool push(const T& item)
+    {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        if (head - tail.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[head & (Capacity - 1)] = item;
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //consumer only
+    bool pop(T& item)
+    {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[tail & (Capacity - 1)];
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //a snapshot, already stale on the other thread
+    size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+private:
+    alignas(64) std::atomic<size_t> head{ 0 };
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    alignas(64) T items[Capacity];
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "VoiceManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+static_assert(VoiceManager::maxSounds <= SoftMixer::maxSounds, "every sound needs a slot in the soft mixer");
+
+VoiceManager::VoiceManager(int channels)
+    : channelCount(std::max(1, channels))
+{
+}
+
+void VoiceManager::open()
+{
+    channelCount = Mix_AllocateChannels(channelCount);
+    voices.assign(channelCount, Voice());
+    coalesced = stolen = dropped = 0;
+}
+
+void VoiceManager::setMixer(SoftMixer* softMixer)
+{
+    haltAll();
+    mixer = softMixer;
+    if (!mixer) {
+        voices.assign(channelCount, Voice());
+        return;
+    }
+    voices.assign(std::min(channelCount, static_cast<int>(SoftMixer::maxVoices)), Voice());
+    for (int sound = 0; sound < maxSounds; ++sound) {
+        mixer->setSound(sound, sounds[sound].chunk);
+    }
+}
+
+void VoiceManager::setSound(int sound, Mix_Chunk* chunk, const VoiceSettings& settings)
+{
+    if (sound < 0 || sound >= maxSounds) {
+        return;
+    }
+    sounds[sound].chunk = chunk;
+    sounds[sound].settings = settings;
+    sounds[sound].settings.maxVoices = std::max(1, settings.maxVoices);
+    sounds[sound].pending = 0;
+    if (mixer) {
+        mixer->setSound(sound, chunk);
+    }
+}
+
+void VoiceManager::trigger(int sound)
+{
+    if (sound >= 0 && sound < maxSounds && sounds[sound].chunk) {
+        sounds[sound].pending++;
+    }
+}
+
+void VoiceManager::update()
+{
+    //channels that finished since the last update are free again
+    for (int channel = 0; channel < static_cast<int>(voices.size()); ++channel) {
+        if (voices[channel].sound >= 0 && !isPlaying(channel)) {
+            voices[channel].sound = -1;
+        }
+    }
+
+    //a rare sound that matters picks its channel before a burst of common ones
+    int order[maxSounds];
+    for (int sound = 0; sound < maxSounds; ++sound) {
+        order[sound] = sound;
+    }
+    std::stable_sort(order, order + maxSounds, [this](int a, int b) {
+        return sounds[a].settings.priority > sounds[b].settings.priority;
+    });
+
+    for (int sound : order) {
+        Sound& entry = sounds[sound];
+        const int count = entry.pending;
+        entry.pending = 0;
+        if (count == 0 || voices.empty()) {
+            continue;
+        }
+        coalesced += count - 1;
+
+        const int channel = pickChannel(sound);
+        if (channel < 0) {
+            dropped += count;
+            continue;
+        }
+        //n copies of the same sound at once add up to about sqrt(n) times as loud
+        const int volume = static_cast<int>(entry.settings.volume * std::sqrt(static_cast<float>(count)));
+        if (!play(channel, sound, std::min(volume, MIX_MAX_VOLUME))) {
+            voices[channel].sound = -1;
+            continue;
+        }
+        voices[channel].sound = sound;
+        voices[channel].priority = entry.settings.priority;
+        voices[channel].started = ++plays;
+    }
+}
+
+int VoiceManager::pickChannel(int sound)
+{
+    //at its cap a sound takes over its own oldest voice
+    int playing = 0, oldestOwn = -1, freeChannel = -1;
+    for (int channel = 0; channel < static_cast<int>(voices.size()); ++channel) {
+        const Voice& voice = voices[channel];
+        if (voice.sound == sound) {
+            playing++;
+            if (oldestOwn < 0 || voice.started < voices[oldestOwn].started) {
+                oldestOwn = channel;
+            }
+        }
+        else if (voice.sound < 0 && freeChannel < 0) {
+            freeChannel = channel;
+        }
+    }
+    if (playing >= sounds[sound].settings.maxVoices) {
+        stolen++;
+        return oldestOwn;
+    }
+    if (freeChannel >= 0) {
+        return freeChannel;
+    }
+
+    //every channel busy: the oldest voice of the lowest priority, if it doesn't matter more than this one
+    const int priority = sounds[sound].settings.priority;
+    int victim = -1;
+    for (int channel = 0; channel < static_cast<int>(voices.size()); ++channel) {
+        const Voice& voice = voices[channel];
+        if (voice.priority > priority) {
+            continue;
+        }
+        if (victim < 0 || voice.priority < voices[victim].priority
+            || (voice.priority == voices[victim].priority && voice.started < voices[victim].started)) {
+            victim = channel;
+        }
+    }
+    if (victim >= 0) {
+        stolen++;
+    }
+    return victim;
+}
+
+bool VoiceManager::isPlaying(int channel) const
+{
+    return mixer ? mixer->isPlaying(channel) : Mix_Playing(channel) != 0;
+}
+
+bool VoiceManager::play(int channel, int sound, int volume)
+{
+    //playing on a busy channel cuts off what was there, on either backend
+    if (mixer) {
+        return mixer->play(channel, sound, static_cast<float>(volume) / MIX_MAX_VOLUME);
+    }
+    Mix_Volume(channel, volume);
+    return Mix_PlayChannel(channel, sounds[sound].chunk, 0) >= 0;
+}
+
+void VoiceManager::haltAll()
+{
+    if (mixer) {
+        mixer->stopAll();
+    }
+    //cleanup runs again from a destructor, after the mixer is closed
+    else if (!voices.empty() && Mix_QuerySpec(nullptr, nullptr, nullptr)) {
+        Mix_HaltChannel(-1);
+    }
+    for (Voice& voice : voices) {
+        voice.sound = -1;
+    }
+    for (Sound& sound : sounds) {
+        sound.pending = 0;
+    }
+}
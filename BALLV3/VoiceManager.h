@@ -0,0 +1,121 @@
+#pragma once
+#ifndef VoiceManager_h
+#define VoiceManager_h
+#include <SDL_mixer.h>
+#include <cstdint>
+#include <vector>
+
+#include "SoftMixer.h"
+
+/*
+* hands SDL_mixer's channels out to sound effects, so a burst of collisions can't take every channel
+*
+* sounds are triggered as events and played once per frame by update(): events of the same sound since
+* the last update become one voice, louder the more of them there were
+* each sound has a priority and a cap on the voices it may play at once
+* a sound at its cap restarts its own oldest voice, and when every channel is busy the oldest voice
+* of the lowest priority is stolen, never one of a higher priority than the sound asking
+* voices play on SDL_mixer's channels, or on a SoftMixer's voices once setMixer attached one
+*
+*     VoiceManager voices(16);
+*     voices.open();                           //after Mix_OpenAudio
+*     voices.setSound(0, hitChunk, { 1, 4, 80 });
+*     voices.trigger(0);                       //any number of times
+*     voices.update();                         //once a frame
+*/
+
+struct VoiceSettings
+{
+    //higher steals from lower
+    int priority;
+    //voices of this sound playing at once, at least 1
+    int maxVoices;
+    //the volume of a single event, 0 to MIX_MAX_VOLUME
+    int volume;
+};
+
+class VoiceManager
+{
+public:
+    //sound ids go from 0 to maxSounds - 1
+    static const int maxSounds = 8;
+
+    /**
+     * @param channels The mixer channels to allocate, SDL_mixer has 8 by default.
+     */
+    explicit VoiceManager(int channels = 16);
+
+    //allocates the channels, after Mix_OpenAudio
+    void open();
+
+    /**
+     * Plays on a SoftMixer instead of SDL_mixer's channels, or back on SDL_mixer for nullptr.
+     * Stops every voice, and hands the mixer the sounds already set.
+     *
+     * @param mixer An open mixer, kept by the caller.
+     */
+    void setMixer(SoftMixer* mixer);
+
+    /**
+     * Sets the chunk and settings of a sound. The chunk stays owned by the caller.
+     *
+     * @param sound The sound's id.
+     * @param chunk The samples, nullptr makes triggering it do nothing.
+     * @param settings Its priority, voice cap and volume.
+     */
+    void setSound(int sound, Mix_Chunk* chunk, const VoiceSettings& settings);
+
+    //counts an event of a sound, played at the next update
+    void trigger(int sound);
+
+    //plays every sound triggered since the last update, highest priority first
+    void update();
+
+    //stops every voice and forgets the events not played yet, before the chunks are freed
+    void haltAll();
+
+    //channels voices may play on, fewer on a SoftMixer with fewer voices
+    int getChannelCount() const { return static_cast<int>(voices.size()); }
+
+    //events folded into a voice of the same sound, since open()
+    uint64_t getCoalesced() const { return coalesced; }
+    //voices cut off to make room
+    uint64_t getStolen() const { return stolen; }
+    //events dropped because only voices of a higher priority were playing
+    uint64_t getDropped() const { return dropped; }
+
+private:
+    struct Sound
+    {
+        Mix_Chunk* chunk = nullptr;
+        VoiceSettings settings = { 0, 1, MIX_MAX_VOLUME };
+        //events since the last update
+        int pending = 0;
+    };
+
+    struct Voice
+    {
+        //-1 when the channel is free
+        int sound = -1;
+        int priority = 0;
+        //when it started, in plays, the smallest is the oldest
+        uint64_t started = 0;
+    };
+
+    //the channel a new voice of this sound plays on, -1 if there is none it may take
+    int pickChannel(int sound);
+    bool isPlaying(int channel) const;
+    bool play(int channel, int sound, int volume);
+
+    int channelCount;
+    SoftMixer* mixer = nullptr;
+    Sound sounds[maxSounds];
+    std::vector<Voice> voices;
+    uint64_t plays = 0;
+
+    uint64_t coalesced = 0;
+    uint64_t stolen = 0;
+    uint64_t dropped = 0;
+};
+
+#endif
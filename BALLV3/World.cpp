@@ -0,0 +1,56 @@
+#include "World.h"
+
+#include <climits>
+
+World::World(int windowWidth, int windowHeight, uint64_t seed, const GameParams& params)
+    : windowWidth(windowWidth), windowHeight(windowHeight), params(params),
+    broadphase(0.0f, -192.0f, static_cast<float>(windowWidth), windowHeight + 384.0f, 64.0f),
+    player(300, 300, TEXTURE_PLAYER, this->windowWidth, this->windowHeight),
+    rng(seed)
+{
+    spawn.entitiesToSpawn = params.firstWaveSize;
+    spawn.entityHealth = params.firstEntityHealth;
+    spawn.wavesPerRamp = params.wavesPerRamp;
+    player.setMaxProjectiles(params.firstMaxProjectiles, params.pointsPerLevel);
+
+    //a few waves and bursts worth, ensureHeadroom grows it from there
+    entities.reserve(64);
+    projectiles.reserve(64);
+    broadphase.reserve(64);
+    spawn.sampler.reserve(64);
+
+    Entity leftWall(0, 0, TEXTURE_WALL, 0.0f, 0.0f, false, INT_MAX, true);
+    Entity rightWall(static_cast<float>(windowWidth - 50), 0, TEXTURE_WALL, 0.0f, 0.0f, false, INT_MAX, true);
+
+    leftWall.getCurrentFrame().h = windowHeight;
+    rightWall.getCurrentFrame().h = windowHeight;
+
+    entities.add(leftWall);
+    entities.add(rightWall);
+}
+
+World World::fork(uint64_t seed) const
+{
+    World copy(*this);
+    copy.rng.seed(seed);
+    return copy;
+}
+
+uint64_t World::checksum(uint64_t hash) const
+{
+    auto add = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        }
+    };
+
+    const EntityRegistry* registries[] = { &entities, &projectiles };
+    for (const EntityRegistry* registry : registries) {
+        add(registry->getPositionsX(), registry->size() * sizeof(float));
+        add(registry->getPositionsY(), registry->size() * sizeof(float));
+    }
+    const int score = player.getScore();
+    add(&score, sizeof(score));
+    return hash;
+}
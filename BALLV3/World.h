@@ -0,0 +1,97 @@
+#pragma once
+#ifndef World_h
+#define World_h
+
+#include "EntityRegistry.h"
+#include "BroadPhase.h"
+#include "Player.h"
+#include "Random.h"
+#include "Entities.h"
+#include "GameEvents.h"
+
+//difficulty knobs of one game, the defaults are the shipped game
+struct GameParams
+{
+    //planets in the first wave and hits each of them takes
+    int firstWaveSize = 3;
+    int firstEntityHealth = 2;
+    //waves between one more planet per wave and one more hit per planet
+    int wavesPerRamp = 5;
+    //projectiles per burst at the start, and the score between one more per burst
+    int firstMaxProjectiles = 2;
+    int pointsPerLevel = 10;
+
+    //per-tick speeds, tuned for Simulation::ticksPerSecond
+    float gravityStrength = 6.0f;
+    int projectileSpeed = 32;
+};
+
+/*
+* everything one game needs: the bodies, the player, the broadphase and the tunables
+* nothing in here touches SDL, the game and the headless runner both drive a World through Simulation::step
+*
+* a World owns all of its state by value, there are no statics behind it, so any number can run side by side
+* on different threads, and a plain copy is a snapshot: stepping the copy never touches the original
+*/
+struct World
+{
+    /**
+     * Creates a world with the two side walls in place and no planets yet.
+     * The first wave is spawned by the first Simulation::step.
+     *
+     * @param windowWidth The width of the playfield in pixels.
+     * @param windowHeight The height of the playfield in pixels.
+     * @param seed Seed of the world's generator. The same seed and the same inputs replay the same game.
+     * @param params Difficulty of the game.
+     */
+    World(int windowWidth, int windowHeight, uint64_t seed, const GameParams& params = GameParams());
+
+    /**
+     * Hashes every body position and the score (FNV-1a over the raw bits).
+     * Two runs that agree on this after every tick played the same game.
+     *
+     * @param hash The hash to continue from, so several worlds can be chained.
+     *
+     * @return The updated hash.
+     */
+    uint64_t checksum(uint64_t hash = 0xCBF29CE484222325ull) const;
+
+    /**
+     * Copies the world and reseeds the copy, so it plays on from the same position with different planets.
+     * A plain copy keeps the seed and replays exactly what the original would.
+     *
+     * @param seed Seed of the copy's generator.
+     *
+     * @return The forked world.
+     */
+    World fork(uint64_t seed) const;
+
+    int windowWidth;
+    int windowHeight;
+    GameParams params;
+
+    EntityRegistry entities;
+    EntityRegistry projectiles;
+
+    //broadphase grid over the playfield, with room above for the game-over line
+    //and below for the wave that is about to scroll in
+    UniformGrid broadphase;
+
+    Player player;
+
+    //every random draw of the simulation comes from here, never from rand()
+    Random rng;
+
+    //wave size and planet health, grows as the game goes on
+    SpawnState spawn;
+    //set by Player::outOfBounds, read by Entity::Spawn to scroll the next wave in
+    bool isOutOfBounds = false;
+    //picks the planet texture, loops after every 5 spawns
+    int spawnCounter = 0;
+    //simulation ticks run so far
+    uint64_t tickCount = 0;
+    //what the last tick raised, cleared by the next one and left out of the checksum
+    GameEventBuffer events;
+};
+
+#endif
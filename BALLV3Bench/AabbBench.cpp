@@ -0,0 +1,124 @@
+#include <bitset>
+#include <vector>
+
+#include "Bench.h"
+#include "AabbBatch.h"
+#include "Collisions.h"
+#include "Random.h"
+
+/*
+* one projectile-sized box against N planet-sized boxes, through Collisions::contact one pair at a time
+* and through each AabbKernel path the CPU supports; every kernel run checks its hits against contact
+* an op tests N pairs, so each path is reported in pairs per ns and as a speedup over contact
+*/
+
+namespace
+{
+    const int queryCount = 256;
+
+    volatile uint32_t sink = 0;
+
+    struct Boxes
+    {
+        std::vector<Rect> rects;
+        std::vector<Rect> queries;
+        PackedAabbs packed;
+    };
+
+    void makeBoxes(Boxes& boxes, size_t count)
+    {
+        Random rng(1234);
+        boxes.rects.resize(count);
+        for (Rect& rect : boxes.rects) {
+            rect = { rng.nextInt(620), rng.nextInt(840), 74, 64 };
+            boxes.packed.push(static_cast<float>(rect.x), static_cast<float>(rect.y), static_cast<float>(rect.w), static_cast<float>(rect.h));
+        }
+        boxes.packed.pad();
+
+        boxes.queries.resize(queryCount);
+        for (Rect& query : boxes.queries) {
+            query = { rng.nextInt(620), rng.nextInt(840), 32, 32 };
+        }
+    }
+
+    uint32_t contactHits(const Boxes& boxes, const Rect& query)
+    {
+        uint32_t hits = 0;
+        for (const Rect& rect : boxes.rects) {
+            hits += Collisions::contact(query, rect);
+        }
+        return hits;
+    }
+
+    uint32_t kernelHits(const Boxes& boxes, const Rect& query)
+    {
+        const float minX = static_cast<float>(query.x), minY = static_cast<float>(query.y);
+        const float maxX = static_cast<float>(query.x + query.w), maxY = static_cast<float>(query.y + query.h);
+        uint32_t hits = 0;
+        for (size_t base = 0; base < boxes.packed.count; base += 16) {
+            hits += static_cast<uint32_t>(std::bitset<32>(AabbKernel::overlapMask(minX, minY, maxX, maxY, boxes.packed, base)).count());
+        }
+        return hits;
+    }
+
+    //one op is one query box against all N boxes
+    void benchContact(BenchState& state)
+    {
+        Boxes boxes;
+        makeBoxes(boxes, state.size());
+        state.setItemsPerOp(static_cast<double>(state.size()));
+
+        size_t query = 0;
+        uint32_t hits = 0;
+        while (state.keepRunning()) {
+            hits += contactHits(boxes, boxes.queries[query]);
+            query = (query + 1) % queryCount;
+        }
+        sink = hits;
+    }
+
+    void benchKernel(BenchState& state, AabbKernel::Path path)
+    {
+        //setPath clamps to what the CPU supports
+        const AabbKernel::Path previous = AabbKernel::getPath();
+        AabbKernel::setPath(path);
+        if (AabbKernel::getPath() != path) {
+            AabbKernel::setPath(previous);
+            state.skip("not supported by this CPU");
+            return;
+        }
+
+        Boxes boxes;
+        makeBoxes(boxes, state.size());
+        for (const Rect& query : boxes.queries) {
+            if (kernelHits(boxes, query) != contactHits(boxes, query)) {
+                AabbKernel::setPath(previous);
+                state.skip("MISMATCH against Collisions::contact");
+                return;
+            }
+        }
+        //the padding boxes are tested too, but only the N real ones count
+        state.setItemsPerOp(static_cast<double>(state.size()));
+
+        size_t query = 0;
+        uint32_t hits = 0;
+        while (state.keepRunning()) {
+            hits += kernelHits(boxes, boxes.queries[query]);
+            query = (query + 1) % queryCount;
+        }
+        sink = hits;
+        AabbKernel::setPath(previous);
+    }
+
+    void benchScalar(BenchState& state) { benchKernel(state, AabbKernel::PATH_SCALAR); }
+    void benchSse2(BenchState& state) { benchKernel(state, AabbKernel::PATH_SSE2); }
+    void benchAvx2(BenchState& state) { benchKernel(state, AabbKernel::PATH_AVX2); }
+    void benchAvx512(BenchState& state) { benchKernel(state, AabbKernel::PATH_AVX512); }
+
+    const char* const baseline = "Collisions::contact";
+    BenchRegistration contact(baseline, benchContact, Bench::bodyCounts(), "pairs");
+    BenchRegistration scalar("AabbKernel::overlapMask/scalar", benchScalar, Bench::bodyCounts(), "pairs", baseline);
+    BenchRegistration sse2("AabbKernel::overlapMask/sse2", benchSse2, Bench::bodyCounts(), "pairs", baseline);
+    BenchRegistration avx2("AabbKernel::overlapMask/avx2", benchAvx2, Bench::bodyCounts(), "pairs", baseline);
+    BenchRegistration avx512("AabbKernel::overlapMask/avx512", benchAvx512, Bench::bodyCounts(), "pairs", baseline);
+}
@@ -0,0 +1,352 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+//every heap allocation of the benchmark executable goes through here so runs can report allocs/op
+namespace
+{
+    std::atomic<uint64_t> allocationTotal(0);
+    std::atomic<uint64_t> byteTotal(0);
+
+    void* countedAlloc(size_t size)
+    {
+        allocationTotal.fetch_add(1, std::memory_order_relaxed);
+        byteTotal.fetch_add(size, std::memory_order_relaxed);
+        void* memory = std::malloc(size ? size : 1);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    struct Registered
+    {
+        std::string name;
+        BenchFunction function;
+        std::vector<size_t> sizes;
+        std::string items;
+        std::string reference;
+    };
+
+    //function-local so registrations from any file are safe during static initialization
+    std::vector<Registered>& registry()
+    {
+        static std::vector<Registered> benchmarks;
+        return benchmarks;
+    }
+
+    BenchResult measure(const Registered& bench, size_t size, double minSeconds)
+    {
+        BenchResult result{ bench.name, size, 0, 0.0, 0.0, 0.0, "", "", 0.0, "", 0.0 };
+        result.items = bench.items;
+        result.reference = bench.reference;
+
+        //grow the iteration count until a run is long enough to trust, aiming a little past the minimum
+        uint64_t iterations = 1;
+        while (true) {
+            BenchState state(size, iterations);
+            bench.function(state);
+
+            if (!state.getSkipReason().empty()) {
+                result.skipReason = state.getSkipReason();
+                return result;
+            }
+
+            const double seconds = state.getSeconds();
+            if (seconds >= minSeconds || iterations >= 1000000000ull) {
+                result.iterations = state.getIterations();
+                result.nsPerOp = seconds * 1e9 / iterations;
+                result.allocsPerOp = static_cast<double>(state.getAllocations()) / iterations;
+                result.bytesPerOp = static_cast<double>(state.getAllocatedBytes()) / iterations;
+                if (state.getItemsPerOp() > 0.0 && result.nsPerOp > 0.0) {
+                    result.itemsPerNs = state.getItemsPerOp() / result.nsPerOp;
+                }
+                return result;
+            }
+
+            uint64_t next = iterations * 10;
+            if (seconds > 0.0) {
+                next = std::min(next, static_cast<uint64_t>(iterations * minSeconds * 1.4 / seconds) + 1);
+            }
+            iterations = std::max(next, iterations + 1);
+        }
+    }
+
+    //every result with a reference gets its speedup over the reference's result at the same size
+    void compareToReferences(std::vector<BenchResult>& results)
+    {
+        for (BenchResult& result : results) {
+            if (result.reference.empty() || result.itemsPerNs <= 0.0) {
+                continue;
+            }
+            for (const BenchResult& reference : results) {
+                if (reference.name == result.reference && reference.size == result.size && reference.itemsPerNs > 0.0) {
+                    result.speedup = result.itemsPerNs / reference.itemsPerNs;
+                }
+            }
+        }
+    }
+
+    //value of "key": in one line written by writeJson
+    bool findField(const std::string& line, const char* key, std::string& value)
+    {
+        const std::string quoted = std::string("\"") + key + "\":";
+        size_t pos = line.find(quoted);
+        if (pos == std::string::npos) {
+            return false;
+        }
+        pos += quoted.size();
+        while (pos < line.size() && line[pos] == ' ') {
+            ++pos;
+        }
+        if (pos < line.size() && line[pos] == '"') {
+            const size_t end = line.find('"', pos + 1);
+            value = line.substr(pos + 1, end - pos - 1);
+        }
+        else {
+            const size_t end = line.find_first_of(",}", pos);
+            value = line.substr(pos, end - pos);
+        }
+        return true;
+    }
+}
+
+//STATE
+
+BenchState::BenchState(size_t size, uint64_t iterations)
+    : parameter(size), iterations(iterations), remaining(iterations)
+{
+}
+
+size_t BenchState::size() const
+{
+    return parameter;
+}
+
+bool BenchState::keepRunning()
+{
+    if (!running && remaining == iterations) {
+        resume();
+    }
+    if (remaining == 0) {
+        if (running) {
+            pause();
+        }
+        return false;
+    }
+    --remaining;
+    return true;
+}
+
+void BenchState::pause()
+{
+    if (!running) {
+        return;
+    }
+    seconds += std::chrono::duration<double>(Clock::now() - started).count();
+    allocations += Bench::allocationCount() - allocationsAtStart;
+    allocatedBytes += Bench::allocatedBytes() - bytesAtStart;
+    running = false;
+}
+
+void BenchState::resume()
+{
+    if (running) {
+        return;
+    }
+    running = true;
+    allocationsAtStart = Bench::allocationCount();
+    bytesAtStart = Bench::allocatedBytes();
+    started = Clock::now();
+}
+
+void BenchState::setItemsPerOp(double items)
+{
+    itemsPerOp = items;
+}
+
+double BenchState::getItemsPerOp() const
+{
+    return itemsPerOp;
+}
+
+void BenchState::skip(const std::string& reason)
+{
+    pause();
+    skipReason = reason;
+    remaining = 0;
+}
+
+uint64_t BenchState::getIterations() const
+{
+    return iterations;
+}
+
+double BenchState::getSeconds() const
+{
+    return seconds;
+}
+
+uint64_t BenchState::getAllocations() const
+{
+    return allocations;
+}
+
+uint64_t BenchState::getAllocatedBytes() const
+{
+    return allocatedBytes;
+}
+
+const std::string& BenchState::getSkipReason() const
+{
+    return skipReason;
+}
+
+BenchRegistration::BenchRegistration(const char* name, BenchFunction function, const std::vector<size_t>& sizes,
+    const char* items, const char* reference)
+{
+    registry().push_back({ name, function, sizes, items ? items : "", reference ? reference : "" });
+}
+
+//RUNNER
+
+std::vector<size_t> Bench::bodyCounts()
+{
+    return { 10, 100, 1000, 10000, 100000 };
+}
+
+std::vector<BenchResult> Bench::runAll(const std::string& filter, double minSeconds, size_t maxSize)
+{
+    //by name, so the order doesn't depend on which file the linker saw first
+    std::vector<Registered> benchmarks = registry();
+    std::stable_sort(benchmarks.begin(), benchmarks.end(),
+        [](const Registered& a, const Registered& b) { return a.name < b.name; });
+
+    std::vector<BenchResult> results;
+    for (const Registered& bench : benchmarks) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        for (size_t size : bench.sizes) {
+            if (size > maxSize) {
+                continue;
+            }
+            results.push_back(measure(bench, size, minSeconds));
+
+            const BenchResult& result = results.back();
+            if (!result.skipReason.empty()) {
+                printf("%-40s %8zu   skipped: %s\n", result.name.c_str(), result.size, result.skipReason.c_str());
+            }
+            else if (result.itemsPerNs > 0.0) {
+                printf("%-40s %8zu %14.1f ns/op %10.2f allocs/op %12.0f B/op %10.3f %s/ns\n", result.name.c_str(), result.size,
+                    result.nsPerOp, result.allocsPerOp, result.bytesPerOp, result.itemsPerNs, result.items.c_str());
+            }
+            else {
+                printf("%-40s %8zu %14.1f ns/op %10.2f allocs/op %12.0f B/op\n", result.name.c_str(), result.size,
+                    result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+            }
+            fflush(stdout);
+        }
+    }
+
+    //references may sort after the benchmarks compared with them, so the comparison waits for every result
+    compareToReferences(results);
+    bool header = false;
+    for (const BenchResult& result : results) {
+        if (result.speedup <= 0.0) {
+            continue;
+        }
+        if (!header) {
+            printf("\n%-40s %8s %14s %24s %8s\n", "throughput against reference", "size", "items/ns", "reference", "speedup");
+            header = true;
+        }
+        printf("%-40s %8zu %10.3f %-3s %24s %7.2fx\n", result.name.c_str(), result.size, result.itemsPerNs,
+            result.items.c_str(), result.reference.c_str(), result.speedup);
+    }
+    return results;
+}
+
+bool Bench::writeJson(const std::string& path, const std::vector<BenchResult>& results)
+{
+    std::ofstream out(path, std::ios::trunc);
+    out << "{\n\"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        char line[768];
+        int length = snprintf(line, sizeof(line),
+            "{\"name\": \"%s\", \"size\": %zu, \"iterations\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, \"bytes_per_op\": %.1f, \"skipped\": \"%s\"",
+            result.name.c_str(), result.size, static_cast<unsigned long long>(result.iterations),
+            result.nsPerOp, result.allocsPerOp, result.bytesPerOp, result.skipReason.c_str());
+        if (result.itemsPerNs > 0.0 && length > 0 && static_cast<size_t>(length) < sizeof(line)) {
+            length += snprintf(line + length, sizeof(line) - length, ", \"items\": \"%s\", \"items_per_ns\": %.4f",
+                result.items.c_str(), result.itemsPerNs);
+        }
+        if (result.speedup > 0.0 && length > 0 && static_cast<size_t>(length) < sizeof(line)) {
+            snprintf(line + length, sizeof(line) - length, ", \"reference\": \"%s\", \"speedup\": %.3f",
+                result.reference.c_str(), result.speedup);
+        }
+        out << line << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n}\n";
+
+    if (!out) {
+        std::cerr << "Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Bench::readJson(const std::string& path, std::vector<BenchResult>& results)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string name, size, nsPerOp, allocsPerOp, bytesPerOp, skipped, items, itemsPerNs, reference, speedup;
+        if (!findField(line, "name", name) || !findField(line, "size", size) || !findField(line, "ns_per_op", nsPerOp)) {
+            continue;
+        }
+        findField(line, "allocs_per_op", allocsPerOp);
+        findField(line, "bytes_per_op", bytesPerOp);
+        findField(line, "skipped", skipped);
+        findField(line, "items", items);
+        findField(line, "items_per_ns", itemsPerNs);
+        findField(line, "reference", reference);
+        findField(line, "speedup", speedup);
+        results.push_back({ name, static_cast<size_t>(strtoull(size.c_str(), nullptr, 10)), 0,
+            atof(nsPerOp.c_str()), atof(allocsPerOp.c_str()), atof(bytesPerOp.c_str()), skipped,
+            items, atof(itemsPerNs.c_str()), reference, atof(speedup.c_str()) });
+    }
+    return true;
+}
+
+uint64_t Bench::allocationCount()
+{
+    return allocationTotal.load(std::memory_order_relaxed);
+}
+
+uint64_t Bench::allocatedBytes()
+{
+    return byteTotal.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,147 @@
+#pragma once
+#ifndef Bench_h
+#define Bench_h
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+* a small benchmark harness: every benchmark is a function run at a list of sizes,
+* it builds its state for the size and then loops on keepRunning, which times the loop
+* and counts the heap allocations made inside it
+*
+*     void benchSomething(BenchState& state)
+*     {
+*         ...setup for state.size()...
+*         while (state.keepRunning()) {
+*             ...one operation...
+*         }
+*     }
+*     static BenchRegistration something("Something", benchSomething, Bench::bodyCounts());
+*
+* the runner grows the iteration count until a run lasts long enough and reports the last run
+* a benchmark that says how many items an operation handles, setItemsPerOp, is also reported as items per ns,
+* and against a reference benchmark named at registration, measured at the same size
+*/
+
+class BenchState
+{
+public:
+    BenchState(size_t size, uint64_t iterations);
+
+    //the parameter of this run, usually a body count
+    size_t size() const;
+
+    //true once per iteration, the clock runs from the first call to the last
+    bool keepRunning();
+
+    //stop and restart the clock and the allocation counter, for resetting state between iterations
+    void pause();
+    void resume();
+
+    //marks the run as not measurable, it is reported with the reason instead of a time
+    void skip(const std::string& reason);
+
+    //how many items, pairs tested for instance, one iteration handles, for the items per ns of the result
+    void setItemsPerOp(double items);
+    double getItemsPerOp() const;
+
+    uint64_t getIterations() const;
+    double getSeconds() const;
+    uint64_t getAllocations() const;
+    uint64_t getAllocatedBytes() const;
+    const std::string& getSkipReason() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    size_t parameter;
+    uint64_t iterations;
+    uint64_t remaining;
+    bool running = false;
+
+    Clock::time_point started;
+    double seconds = 0.0;
+    uint64_t allocationsAtStart = 0, bytesAtStart = 0;
+    uint64_t allocations = 0, allocatedBytes = 0;
+    double itemsPerOp = 0.0;
+    std::string skipReason;
+};
+
+typedef void (*BenchFunction)(BenchState& state);
+
+//adds a benchmark to the suite, meant for a static object next to the function
+struct BenchRegistration
+{
+    /**
+     * @param name The name results are reported under.
+     * @param function The benchmark.
+     * @param sizes The sizes it runs at.
+     * @param items What setItemsPerOp counts, "pairs" for instance, nullptr when it isn't called.
+     * @param reference The benchmark whose items per ns at the same size this one is compared with, nullptr for none.
+     */
+    BenchRegistration(const char* name, BenchFunction function, const std::vector<size_t>& sizes,
+        const char* items = nullptr, const char* reference = nullptr);
+};
+
+struct BenchResult
+{
+    std::string name;
+    size_t size;
+    uint64_t iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+    std::string skipReason;
+    //throughput, for benchmarks that set their items per op, 0 otherwise
+    std::string items;
+    double itemsPerNs = 0.0;
+    //items per ns over the reference's at the same size, 0 without a reference result
+    std::string reference;
+    double speedup = 0.0;
+};
+
+namespace Bench
+{
+    //10 to 100k, the entity and projectile counts every simulation benchmark runs at
+    std::vector<size_t> bodyCounts();
+
+    /**
+     * Runs every registered benchmark whose name contains the filter.
+     *
+     * @param filter Substring of the names to run, empty runs everything.
+     * @param minSeconds The shortest timed run that is reported.
+     * @param maxSize Sizes above this are left out.
+     *
+     * @return One result per benchmark and size, in registration order.
+     */
+    std::vector<BenchResult> runAll(const std::string& filter, double minSeconds, size_t maxSize);
+
+    /**
+     * Writes results as JSON, one benchmark per line so runs from two commits diff cleanly.
+     *
+     * @param path The file to create or overwrite.
+     * @param results The results to write.
+     *
+     * @return true if the whole file was written, false otherwise.
+     */
+    bool writeJson(const std::string& path, const std::vector<BenchResult>& results);
+
+    /**
+     * Reads results written by writeJson.
+     *
+     * @param path The file to read.
+     * @param results Filled with the results of the file.
+     *
+     * @return true if the file could be read, false otherwise.
+     */
+    bool readJson(const std::string& path, std::vector<BenchResult>& results);
+
+    //heap allocations made by the process so far, counted by the operator new of the benchmark executable
+    uint64_t allocationCount();
+    uint64_t allocatedBytes();
+}
+
+#endif
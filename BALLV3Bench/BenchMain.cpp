@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+
+/*
+* runs the benchmark suite and prints ns/op and allocations/op for every benchmark and size
+*
+* usage: ballbench [--filter TEXT] [--min-time S] [--max-size N] [--json FILE] [--baseline FILE]
+* --json saves the results, --baseline prints each result next to a saved run, e.g. one from the previous commit
+*/
+
+namespace
+{
+    void compare(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline)
+    {
+        printf("\n%-40s %8s %12s %12s %8s %14s\n", "compared to baseline", "size", "old ns/op", "new ns/op", "change", "allocs/op");
+        for (const BenchResult& result : results) {
+            for (const BenchResult& old : baseline) {
+                if (old.name != result.name || old.size != result.size || !old.skipReason.empty() || !result.skipReason.empty()) {
+                    continue;
+                }
+                const double change = old.nsPerOp > 0.0 ? 100.0 * (result.nsPerOp - old.nsPerOp) / old.nsPerOp : 0.0;
+                printf("%-40s %8zu %12.1f %12.1f %+7.1f%% %6.2f -> %-6.2f\n", result.name.c_str(), result.size,
+                    old.nsPerOp, result.nsPerOp, change, old.allocsPerOp, result.allocsPerOp);
+            }
+        }
+    }
+}
+
+int main(int argc, char* args[])
+{
+    std::string filter;
+    double minSeconds = 0.2;
+    size_t maxSize = 100000;
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* option = args[i];
+        const char* value = i + 1 < argc ? args[i + 1] : nullptr;
+        if (!value) {
+            fprintf(stderr, "%s needs a value\n", option);
+            return 1;
+        }
+        ++i;
+
+        if (strcmp(option, "--filter") == 0) filter = value;
+        else if (strcmp(option, "--min-time") == 0) minSeconds = atof(value);
+        else if (strcmp(option, "--max-size") == 0) maxSize = static_cast<size_t>(strtoull(value, nullptr, 10));
+        else if (strcmp(option, "--json") == 0) jsonPath = value;
+        else if (strcmp(option, "--baseline") == 0) baselinePath = value;
+        else {
+            fprintf(stderr, "unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> baseline;
+    if (baselinePath && !Bench::readJson(baselinePath, baseline)) {
+        return 1;
+    }
+
+    const std::vector<BenchResult> results = Bench::runAll(filter, minSeconds, maxSize);
+    if (results.empty()) {
+        fprintf(stderr, "no benchmark matches \"%s\"\n", filter.c_str());
+        return 1;
+    }
+
+    if (jsonPath && !Bench::writeJson(jsonPath, results)) {
+        return 1;
+    }
+    if (baselinePath) {
+        compare(results, baseline);
+    }
+    return 0;
+}
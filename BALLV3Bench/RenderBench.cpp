@@ -0,0 +1,266 @@
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "Bench.h"
+#include "FontManager.h"
+#include "GlyphAtlas.h"
+#include "Player.h"
+#include "GameEvents.h"
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "Random.h"
+
+/*
+* the score text at a starting score of 10 to 100k, 1 to 100 lines of HUD text, and 10 to 100k sprites, drawn into an offscreen
+* software renderer so it runs without a window; needs SDL and SDL_ttf, the headless make build leaves it out
+*
+* RenderQueue/recorded replays the frames of a game started with --record-render render.frames,
+* looked for in the same folders as the font, and is skipped when there is none
+*/
+
+namespace
+{
+    const char* fontPaths[] = { "HomeVideoBold-R90Dv.ttf", "../BALLV3/HomeVideoBold-R90Dv.ttf", "BALLV3/HomeVideoBold-R90Dv.ttf" };
+    const char* renderFramePaths[] = { "render.frames", "../BALLV3/render.frames", "BALLV3/render.frames" };
+
+    //one offscreen target shared by every run, made on first use
+    SDL_Renderer* offscreenRenderer()
+    {
+        static SDL_Renderer* renderer = nullptr;
+        static bool tried = false;
+        if (tried) {
+            return renderer;
+        }
+        tried = true;
+
+        if (SDL_Init(0) != 0 || TTF_Init() == -1) {
+            return nullptr;
+        }
+        bool fontLoaded = false;
+        //run from the project folder, the repository root or next to the game's assets
+        for (const char* path : fontPaths) {
+            std::ifstream exists(path);
+            if (!fontLoaded && exists) {
+                fontLoaded = FontManager::Instance().LoadFont("bench", path, 24);
+            }
+        }
+        if (!fontLoaded) {
+            return nullptr;
+        }
+
+        SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, 620, 840, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+        return renderer;
+    }
+
+    void benchRenderScore(BenchState& state, bool scoreChanges)
+    {
+        SDL_Renderer* renderer = offscreenRenderer();
+        if (!renderer) {
+            state.skip("no SDL renderer or font");
+            return;
+        }
+
+        int width = 620, height = 840;
+        Player player(32, 32, TEXTURE_PLAYER, width, height);
+        GameEventBuffer events;
+        for (size_t i = 0; i < state.size(); ++i) {
+            player.incrementScore(events);
+        }
+        SDL_Color white = { 255, 255, 255, 255 };
+        FontManager::Instance().RenderScore("bench", white, 60, 20, renderer, player);
+
+        while (state.keepRunning()) {
+            if (scoreChanges) {
+                player.incrementScore(events);
+            }
+            FontManager::Instance().RenderScore("bench", white, 60, 20, renderer, player);
+        }
+    }
+
+    //N lines of overlay text a frame, each one of a few strings that keep changing
+    void benchText(BenchState& state, bool glyphAtlas)
+    {
+        SDL_Renderer* renderer = offscreenRenderer();
+        GlyphAtlas* glyphs = FontManager::Instance().GetGlyphs("bench");
+        if (!renderer || !glyphs) {
+            state.skip("no SDL renderer or font");
+            return;
+        }
+
+        TTF_Font* font = FontManager::Instance().GetFont("bench");
+        const SDL_Color white = { 255, 255, 255, 255 };
+        SpriteBatch batch(renderer);
+        batch.reserve(state.size() * 32);
+        char line[64];
+        int frame = 0;
+        while (state.keepRunning()) {
+            for (size_t i = 0; i < state.size(); ++i) {
+                snprintf(line, sizeof(line), "frame %d  line %zu  p99 %.1f ms", frame, i, (frame + i) * 0.1);
+                const int y = static_cast<int>(i % 30) * 26;
+                if (glyphAtlas) {
+                    glyphs->draw(batch, renderer, line, white, 8, y);
+                }
+                else {
+                    SDL_Surface* surface = TTF_RenderText_Solid(font, line, white);
+                    SDL_Texture* texture = surface ? SDL_CreateTextureFromSurface(renderer, surface) : nullptr;
+                    if (texture) {
+                        const SDL_Rect dst = { 8, y, surface->w, surface->h };
+                        SDL_RenderCopy(renderer, texture, nullptr, &dst);
+                        SDL_DestroyTexture(texture);
+                    }
+                    SDL_FreeSurface(surface);
+                }
+            }
+            batch.flush();
+            frame++;
+        }
+    }
+
+    //what FontManager::RenderText did before the glyph atlas: rasterize, upload, draw and destroy every call
+    void benchTextTtf(BenchState& state) { benchText(state, false); }
+    //what it does now: quads from the cached glyphs, every line of the frame in one call
+    void benchTextGlyphAtlas(BenchState& state) { benchText(state, true); }
+
+    //N 32x32 sprites spread over a 620x840 frame, each from one of two 64x64 cells of a sheet
+    void benchSprites(BenchState& state, bool batched)
+    {
+        SDL_Renderer* renderer = offscreenRenderer();
+        if (!renderer) {
+            state.skip("no SDL renderer or font");
+            return;
+        }
+
+        SDL_Texture* sheet = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 128, 64);
+        if (!sheet) {
+            state.skip("no texture");
+            return;
+        }
+        SDL_SetTextureBlendMode(sheet, SDL_BLENDMODE_BLEND);
+
+        Random rng(state.size());
+        std::vector<SDL_Rect> dst(state.size());
+        for (SDL_Rect& rect : dst) {
+            rect = { static_cast<int>(rng.nextFloat() * 588), static_cast<int>(rng.nextFloat() * 808), 32, 32 };
+        }
+        SpriteBatch batch(renderer);
+        batch.reserve(state.size());
+
+        while (state.keepRunning()) {
+            for (size_t i = 0; i < dst.size(); ++i) {
+                const Rect src = { static_cast<int>(i % 2) * 64, 0, 64, 64 };
+                if (batched) {
+                    const SDL_FRect to = { static_cast<float>(dst[i].x), static_cast<float>(dst[i].y), 32.0f, 32.0f };
+                    batch.draw(sheet, src, to);
+                }
+                else {
+                    const SDL_Rect from = { src.x, src.y, src.w, src.h };
+                    SDL_RenderCopy(renderer, sheet, &from, &dst[i]);
+                }
+            }
+            batch.flush();
+        }
+        SDL_DestroyTexture(sheet);
+    }
+
+    //what RenderWindow did before the atlas: one SDL_RenderCopy per sprite
+    void benchSpritesCopy(BenchState& state) { benchSprites(state, false); }
+    //what it does now: every sprite of the frame in one SDL_RenderGeometry call
+    void benchSpritesBatched(BenchState& state) { benchSprites(state, true); }
+
+    //N sprites pushed in an order that alternates four textures and two layers, then sorted and submitted
+    void benchRenderQueue(BenchState& state)
+    {
+        SDL_Renderer* renderer = offscreenRenderer();
+        if (!renderer) {
+            state.skip("no SDL renderer or font");
+            return;
+        }
+
+        RenderQueue queue(renderer);
+        SDL_Texture* textures[4] = {};
+        for (SDL_Texture*& texture : textures) {
+            texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, 64, 64);
+            queue.addTexture(texture);
+        }
+        queue.reserve(state.size());
+
+        Random rng(state.size());
+        std::vector<Rect> dst(state.size());
+        for (Rect& rect : dst) {
+            rect = { static_cast<int>(rng.nextFloat() * 588), static_cast<int>(rng.nextFloat() * 808), 32, 32 };
+        }
+
+        while (state.keepRunning()) {
+            for (size_t i = 0; i < dst.size(); ++i) {
+                queue.push(LAYER_BODIES + static_cast<int>(i / 4 % 2), static_cast<int>(i % 4), { 0, 0, 64, 64 }, dst[i]);
+            }
+            queue.submit();
+        }
+        for (SDL_Texture* texture : textures) {
+            SDL_DestroyTexture(texture);
+        }
+    }
+
+    //one recorded game frame per iteration, blank textures of the recorded sizes standing in for the real ones
+    void benchRecordedFrames(BenchState& state)
+    {
+        SDL_Renderer* renderer = offscreenRenderer();
+        RenderRecording recording;
+        bool loaded = false;
+        for (const char* path : renderFramePaths) {
+            std::ifstream exists(path);
+            if (!loaded && exists) {
+                loaded = recording.load(path);
+            }
+        }
+        if (!renderer || !loaded || recording.getFrameCount() == 0) {
+            state.skip("no SDL renderer or no render.frames");
+            return;
+        }
+
+        RenderQueue queue(renderer);
+        std::vector<SDL_Texture*> textures;
+        for (int handle = 0; handle < recording.getTextureCount(); ++handle) {
+            const SDL_Point size = recording.getTextureSize(handle);
+            textures.push_back(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                std::max(size.x, 1), std::max(size.y, 1)));
+            queue.addTexture(textures.back());
+        }
+
+        size_t frame = 0;
+        while (state.keepRunning()) {
+            state.pause();
+            recording.replayFrame(frame, queue);
+            state.resume();
+
+            queue.submit();
+            if (++frame == recording.getFrameCount()) {
+                frame = 0;
+            }
+        }
+        for (SDL_Texture* texture : textures) {
+            SDL_DestroyTexture(texture);
+        }
+    }
+
+    //the common frame: same score as last frame, the cached texture is drawn again
+    void benchRenderScoreCached(BenchState& state) { benchRenderScore(state, false); }
+    //a hit every frame: the text is rasterized and uploaded again
+    void benchRenderScoreChanged(BenchState& state) { benchRenderScore(state, true); }
+
+    BenchRegistration renderScoreCached("FontManager::RenderScore/cached", benchRenderScoreCached, Bench::bodyCounts());
+    BenchRegistration renderScoreChanged("FontManager::RenderScore/changed", benchRenderScoreChanged, Bench::bodyCounts());
+    BenchRegistration textTtf("text/TTF_RenderText", benchTextTtf, { 1, 10, 100 });
+    BenchRegistration textGlyphAtlas("text/GlyphAtlas", benchTextGlyphAtlas, { 1, 10, 100 });
+    BenchRegistration spritesCopy("sprites/SDL_RenderCopy", benchSpritesCopy, Bench::bodyCounts());
+    BenchRegistration spritesBatched("sprites/SpriteBatch", benchSpritesBatched, Bench::bodyCounts());
+    BenchRegistration renderQueue("RenderQueue::submit", benchRenderQueue, Bench::bodyCounts());
+    BenchRegistration recordedFrames("RenderQueue/recorded", benchRecordedFrames, { 1 });
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Bench.h"
+#include "Collisions.h"
+#include "Entities.h"
+#include "EntityRegistry.h"
+#include "BroadPhase.h"
+#include "Player.h"
+#include "Random.h"
+#include "GameEvents.h"
+
+/*
+* the per-tick simulation functions at 10 to 100k bodies
+*
+* planets are scattered over a square field that grows with the count, about one per 128x128 px
+* like a busy game screen, so the broadphase sees the same density at every size
+* functions that kill or add bodies restore a copy of the registry between iterations, outside the clock,
+* and run once untimed first so allocs/op shows steady state rather than the first call growing buffers
+*/
+
+namespace
+{
+    const float pi = 3.14159265358979f;
+    const float projectileSpeed = 32.0f;
+
+    volatile int sink = 0;
+
+    float fieldSide(size_t bodies)
+    {
+        return std::max(620.0f, std::ceil(std::sqrt(static_cast<float>(bodies))) * 128.0f);
+    }
+
+    void addPlanets(EntityRegistry& entities, Random& rng, size_t count, float side)
+    {
+        entities.reserve(count + 64);
+        for (size_t i = 0; i < count; ++i) {
+            entities.add(Entity(std::floor(rng.nextFloat() * side), std::floor(rng.nextFloat() * side),
+                TEXTURE_PLANET1, 0.0f, 0.0f, false, 2));
+        }
+    }
+
+    void addProjectiles(EntityRegistry& projectiles, Random& rng, size_t count, float side)
+    {
+        projectiles.reserve(count + 64);
+        for (size_t i = 0; i < count; ++i) {
+            const float angle = rng.nextFloat() * 2.0f * pi;
+            projectiles.add(Entity(rng.nextFloat() * side, rng.nextFloat() * side, TEXTURE_PROJECTILE,
+                projectileSpeed * std::cos(angle), projectileSpeed * std::sin(angle), true));
+        }
+    }
+
+    //one tick of collisions: N planets, N projectiles
+    void benchCheckCollisions(BenchState& state)
+    {
+        const float side = fieldSide(state.size());
+        Random rng(state.size());
+        EntityRegistry startEntities, startProjectiles;
+        addPlanets(startEntities, rng, state.size(), side);
+        addProjectiles(startProjectiles, rng, state.size(), side);
+
+        EntityRegistry entities = startEntities, projectiles = startProjectiles;
+        UniformGrid broadphase(0.0f, 0.0f, side, side, 64.0f);
+        broadphase.reserve(state.size());
+        GameEventBuffer events;
+
+        //untimed first tick, it builds the grid and grows the query buffers once
+        Collisions::checkCollisions(entities, projectiles, broadphase, events);
+
+        while (state.keepRunning()) {
+            state.pause();
+            entities = startEntities;
+            projectiles = startProjectiles;
+            events.clear();
+            state.resume();
+
+            sink = Collisions::checkCollisions(entities, projectiles, broadphase, events);
+        }
+    }
+
+    //a single bounce off a planet right below the projectile, cycling through N projectiles
+    //every op puts the projectile back where the planet was placed for, a bounce moves it and flips its velocity
+    void benchBounceProjectile(BenchState& state)
+    {
+        const float side = fieldSide(state.size());
+        Random rng(state.size());
+        EntityRegistry projectiles;
+        addProjectiles(projectiles, rng, state.size(), side);
+
+        std::vector<Rect> below(state.size());
+        for (size_t i = 0; i < below.size(); ++i) {
+            const Rect hitbox = projectiles.getHitbox(i);
+            below[i] = { hitbox.x - 16, hitbox.y + hitbox.h - 4, 74, 64 };
+        }
+        const std::vector<float> startX(projectiles.getPositionsX(), projectiles.getPositionsX() + projectiles.size());
+        const std::vector<float> startY(projectiles.getPositionsY(), projectiles.getPositionsY() + projectiles.size());
+        const std::vector<float> startVelocityX(projectiles.getVelocitiesX(), projectiles.getVelocitiesX() + projectiles.size());
+        const std::vector<float> startVelocityY(projectiles.getVelocitiesY(), projectiles.getVelocitiesY() + projectiles.size());
+
+        size_t index = 0;
+        while (state.keepRunning()) {
+            //four stores, cheaper than pausing the clock around them
+            projectiles.getPositionsX()[index] = startX[index];
+            projectiles.getPositionsY()[index] = startY[index];
+            projectiles.getVelocitiesX()[index] = startVelocityX[index];
+            projectiles.getVelocitiesY()[index] = startVelocityY[index];
+            Collisions::bounceProjectile(projectiles, index, below[index]);
+            if (++index == below.size()) {
+                index = 0;
+            }
+        }
+    }
+
+    //one gravity pass over N projectiles
+    void benchApplyGravity(BenchState& state)
+    {
+        const float side = fieldSide(state.size());
+        Random rng(state.size());
+        EntityRegistry projectiles;
+        addProjectiles(projectiles, rng, state.size(), side);
+
+        while (state.keepRunning()) {
+            Collisions::applyGravity(projectiles, 6.0f);
+        }
+    }
+
+    //one out-of-bounds pass over N projectiles in a 620x840 window, about half of them outside
+    void benchOutOfBounds(BenchState& state)
+    {
+        int width = 620, height = 840;
+        Random rng(state.size());
+        EntityRegistry startProjectiles;
+        startProjectiles.reserve(state.size());
+        for (size_t i = 0; i < state.size(); ++i) {
+            startProjectiles.add(Entity(rng.nextFloat() * 2.0f * width - width / 2, rng.nextFloat() * height,
+                TEXTURE_PROJECTILE, 0.0f, projectileSpeed, true));
+        }
+
+        EntityRegistry projectiles = startProjectiles;
+        GameEventBuffer events;
+        bool outOfBounds = false;
+
+        while (state.keepRunning()) {
+            state.pause();
+            projectiles = startProjectiles;
+            events.clear();
+            state.resume();
+
+            sink = Player::outOfBounds(projectiles, width, height, &outOfBounds, events);
+        }
+    }
+
+    //one scrolling wave on top of N planets stacked in rows above the screen, like a long game
+    void benchSpawn(BenchState& state)
+    {
+        const int width = 620, height = 840;
+        EntityRegistry startEntities;
+        startEntities.reserve(state.size() + 64);
+        for (size_t i = 0; i < state.size(); ++i) {
+            const float row = static_cast<float>(i / 4);
+            startEntities.add(Entity(static_cast<float>(i % 4) * 128.0f, height - 128.0f - row * 128.0f,
+                TEXTURE_PLANET1, 0.0f, 0.0f, false, 2));
+        }
+
+        EntityRegistry entities = startEntities;
+        SpawnState startSpawn;
+        startSpawn.initialSpawn = true;
+        startSpawn.toggleSpawn = true;
+        startSpawn.sampler.reserve(state.size() + 64);
+        SpawnState spawn = startSpawn;
+        Random rng(state.size());
+        bool outOfBounds = true;
+
+        //untimed first wave, it grows the registry to the wave's headroom once
+        Entity::Spawn(entities, rng, spawn, TEXTURE_PLANET1, width, height, &outOfBounds);
+
+        while (state.keepRunning()) {
+            state.pause();
+            entities = startEntities;
+            spawn = startSpawn;
+            state.resume();
+
+            Entity::Spawn(entities, rng, spawn, TEXTURE_PLANET1, width, height, &outOfBounds);
+        }
+    }
+
+    void benchRegistryHitbox(BenchState& state)
+    {
+        const float side = fieldSide(state.size());
+        Random rng(state.size());
+        EntityRegistry entities;
+        addPlanets(entities, rng, state.size(), side);
+
+        size_t index = 0;
+        int total = 0;
+        while (state.keepRunning()) {
+            total += entities.getHitbox(index).w;
+            if (++index == entities.size()) {
+                index = 0;
+            }
+        }
+        sink = total;
+    }
+
+    void benchEntityHitbox(BenchState& state)
+    {
+        const float side = fieldSide(state.size());
+        Random rng(state.size());
+        std::vector<Entity> entities;
+        entities.reserve(state.size());
+        for (size_t i = 0; i < state.size(); ++i) {
+            entities.push_back(Entity(std::floor(rng.nextFloat() * side), std::floor(rng.nextFloat() * side), TEXTURE_PLANET1));
+        }
+
+        size_t index = 0;
+        int total = 0;
+        while (state.keepRunning()) {
+            total += entities[index].getHitbox().w;
+            if (++index == entities.size()) {
+                index = 0;
+            }
+        }
+        sink = total;
+    }
+
+    BenchRegistration checkCollisions("Collisions::checkCollisions", benchCheckCollisions, Bench::bodyCounts());
+    BenchRegistration bounceProjectile("Collisions::bounceProjectile", benchBounceProjectile, Bench::bodyCounts());
+    BenchRegistration applyGravity("Collisions::applyGravity", benchApplyGravity, Bench::bodyCounts());
+    BenchRegistration outOfBounds("Player::outOfBounds", benchOutOfBounds, Bench::bodyCounts());
+    BenchRegistration spawn("Entity::Spawn", benchSpawn, Bench::bodyCounts());
+    BenchRegistration registryHitbox("EntityRegistry::getHitbox", benchRegistryHitbox, Bench::bodyCounts());
+    BenchRegistration entityHitbox("Entity::getHitbox", benchEntityHitbox, Bench::bodyCounts());
+}
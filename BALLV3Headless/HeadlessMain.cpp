@@ -0,0 +1,190 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "World.h"
+#include "Simulation.h"
+#include "Replay.h"
+#include "AimBot.h"
+#include "Scenario.h"
+#include "Profiler.h"
+
+/*
+* runs the game logic with no window and no sound card: a bot aims at the highest planet
+* and keeps SPACE held, the world restarts on game over, and the throughput is printed at the end
+*
+* usage: ballsim [--ticks N] [--seed N] [--record FILE] [--trace FILE]
+*        ballsim --replay FILE
+*        ballsim --scenario FILE [--trace FILE]
+* the same ticks and seed always print the same checksum
+* --record stops at the first game over so the file holds one game
+* --replay plays a recording as fast as possible and checks it against its keyframes
+* --scenario plays every stress scene of a scenario file flat out, prints tick-time percentiles and
+*   peak memory, and exits with 3 if any scene went over one of its budgets
+* --trace writes the profiling zones as a Chrome trace at the end, in builds made with PROFILE=1
+*/
+
+namespace
+{
+    const int windowWidth = 620;
+    const int windowHeight = 840;
+
+    //a no-op unless the zones were compiled in
+    bool writeTrace(const char* path)
+    {
+        if (!path || !Profiler::isEnabled()) {
+            return true;
+        }
+        if (!Profiler::writeChromeTrace(path)) {
+            return false;
+        }
+        printf("trace written to %s, %llu zones dropped\n", path, static_cast<unsigned long long>(Profiler::getDroppedCount()));
+        return true;
+    }
+
+    int playReplay(const char* path)
+    {
+        ReplayPlayer replay;
+        if (!replay.load(path)) {
+            return 1;
+        }
+
+        World world = replay.createWorld();
+
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point start = Clock::now();
+        const bool inSync = replay.seek(world, replay.getLength());
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        printf("%llu ticks in %.3f s, %.0f ticks/s\n", static_cast<unsigned long long>(world.tickCount),
+            seconds, world.tickCount / seconds);
+        printf("score %d, %s\n", world.player.getScore(), inSync ? "in sync" : "DESYNC");
+        return inSync ? 0 : 2;
+    }
+
+    int playScenarios(const char* path)
+    {
+        std::vector<Scenario> scenarios;
+        if (!Scenario::loadFile(path, scenarios)) {
+            return 1;
+        }
+
+        bool overBudget = false;
+        printf("%-24s %7s %9s %9s %9s %9s %9s %8s %7s\n", "scenario", "ticks", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms", "peak MB", "bodies");
+        for (const Scenario& scenario : scenarios) {
+            ScenarioRun::resetPeakMemory();
+            ScenarioRun run(scenario);
+            while (run.tick()) {
+            }
+
+            const ScenarioResult result = run.getResult();
+            printf("%-24s %7llu %9.3f %9.3f %9.3f %9.3f %9.3f %8.1f %7zu\n", result.name.c_str(),
+                static_cast<unsigned long long>(result.ticks), result.meanMs, result.p50Ms, result.p95Ms,
+                result.p99Ms, result.maxMs, result.peakMemoryMb, result.bodiesAtEnd);
+            for (const std::string& line : result.overBudget) {
+                printf("  OVER BUDGET: %s\n", line.c_str());
+                overBudget = true;
+            }
+        }
+        return overBudget ? 3 : 0;
+    }
+}
+
+int main(int argc, char* args[])
+{
+    long long ticks = 10000;
+    uint64_t seed = 1;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* scenarioPath = nullptr;
+    const char* tracePath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(args[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = atoll(args[++i]);
+        }
+        else if (strcmp(args[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(args[++i], nullptr, 10);
+        }
+        else if (strcmp(args[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = args[++i];
+        }
+        else if (strcmp(args[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = args[++i];
+        }
+        else if (strcmp(args[i], "--scenario") == 0 && i + 1 < argc) {
+            scenarioPath = args[++i];
+        }
+        else if (strcmp(args[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = args[++i];
+        }
+        else {
+            fprintf(stderr, "usage: %s [--ticks N] [--seed N] [--record FILE] [--trace FILE]\n       %s --replay FILE\n       %s --scenario FILE [--trace FILE]\n", args[0], args[0], args[0]);
+            return 1;
+        }
+    }
+
+    Profiler::setThreadName("ballsim");
+    if (replayPath) {
+        return playReplay(replayPath);
+    }
+    if (scenarioPath) {
+        const int result = playScenarios(scenarioPath);
+        return writeTrace(tracePath) ? result : 1;
+    }
+
+    World world(windowWidth, windowHeight, seed);
+    ReplayRecorder recorder(world);
+    AimBot bot(seed);
+    uint64_t hash = world.checksum();
+    int games = 1;
+    int bestScore = 0;
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    for (long long tick = 0; tick < ticks; ++tick) {
+        if (bot.play(world)) {
+            recorder.recordFire(world);
+        }
+
+        const bool running = Simulation::step(world);
+        recorder.recordStep(world);
+        if (!running) {
+            if (recordPath) {
+                ticks = tick + 1;
+                break;
+            }
+            if (world.player.getScore() > bestScore) {
+                bestScore = world.player.getScore();
+            }
+            hash = world.checksum(hash);
+            world = World(windowWidth, windowHeight, seed + games);
+            games++;
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (world.player.getScore() > bestScore) {
+        bestScore = world.player.getScore();
+    }
+
+    printf("%lld ticks in %.3f s, %.0f ticks/s (%.1fx real time)\n",
+        ticks, seconds, ticks / seconds, ticks / seconds / Simulation::ticksPerSecond);
+    printf("%d games, best score %d\n", games, bestScore);
+    printf("seed %llu, checksum %016llx\n", static_cast<unsigned long long>(seed),
+        static_cast<unsigned long long>(world.checksum(hash)));
+    if (!writeTrace(tracePath)) {
+        return 1;
+    }
+
+    if (recordPath) {
+        if (!recorder.save(recordPath)) {
+            return 1;
+        }
+        printf("recorded %lld ticks to %s, %zu bytes of input\n", ticks, recordPath, recorder.getEventBytes());
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "World.h"
+#include "Simulation.h"
+#include "AimBot.h"
+#include "Profiler.h"
+
+/*
+* plays thousands of bot games per difficulty setting and prints score, game length and survival
+*
+* usage: ballmc [--games N] [--threads N] [--seed N] [--jitter PX] [--max-seconds S]
+*               [--wave-size LIST] [--health LIST] [--ramp LIST]
+*               [--projectiles LIST] [--level-points LIST] [--gravity LIST] [--trace FILE]
+* a LIST is comma separated, e.g. --gravity 4,6,8, and every combination of the lists is played
+*
+* each worker thread owns its worlds outright and writes to its own slice of the results,
+* so nothing is shared while games run and game g gets the same seed whatever the thread count
+* --trace writes the profiling zones of every thread as a Chrome trace, in builds made with PROFILE=1
+*/
+
+namespace
+{
+    const int windowWidth = 620;
+    const int windowHeight = 840;
+
+    //seconds of game time the survival curve is sampled at
+    const double survivalSeconds[] = { 1, 2, 3, 5, 10, 20, 40 };
+
+    struct GameResult
+    {
+        int score;
+        uint64_t ticks;
+    };
+
+    struct RunOptions
+    {
+        int games = 1000;
+        int threads = 0;
+        uint64_t seed = 1;
+        int jitter = 16;
+        double maxSeconds = 600.0;
+        const char* tracePath = nullptr;
+    };
+
+    std::vector<float> parseList(const char* text)
+    {
+        std::vector<float> values;
+        std::string list(text);
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            values.push_back(strtof(list.substr(start, end - start).c_str(), nullptr));
+            start = end + 1;
+        }
+        return values;
+    }
+
+    GameResult playGame(const GameParams& params, const RunOptions& options, uint64_t game)
+    {
+        PROFILE_ZONE("game");
+        World world(windowWidth, windowHeight, options.seed + game, params);
+        AimBot bot(~(options.seed + game), options.jitter);
+
+        const uint64_t maxTicks = static_cast<uint64_t>(options.maxSeconds * Simulation::ticksPerSecond);
+        while (world.tickCount < maxTicks) {
+            bot.play(world);
+            if (!Simulation::step(world)) {
+                break;
+            }
+        }
+        return { world.player.getScore(), world.tickCount };
+    }
+
+    void playWorker(const GameParams& params, const RunOptions& options, int first, int last, GameResult* results)
+    {
+        const std::string name = "worker " + std::to_string(first) + "-" + std::to_string(last);
+        Profiler::setThreadName(name.c_str());
+        for (int game = first; game < last; ++game) {
+            results[game] = playGame(params, options, static_cast<uint64_t>(game));
+        }
+    }
+
+    template <typename T>
+    T percentile(const std::vector<T>& sorted, double fraction)
+    {
+        size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    void report(const GameParams& params, const std::vector<GameResult>& results, double wallSeconds)
+    {
+        std::vector<int> scores;
+        std::vector<uint64_t> lengths;
+        uint64_t totalTicks = 0;
+        double scoreSum = 0.0;
+        for (const GameResult& result : results) {
+            scores.push_back(result.score);
+            lengths.push_back(result.ticks);
+            totalTicks += result.ticks;
+            scoreSum += result.score;
+        }
+        std::sort(scores.begin(), scores.end());
+        std::sort(lengths.begin(), lengths.end());
+
+        const double tickSeconds = Simulation::tickSeconds;
+        printf("wave %d, health %d, ramp every %d waves, burst %d +1 every %d points, gravity %.2f\n",
+            params.firstWaveSize, params.firstEntityHealth, params.wavesPerRamp,
+            params.firstMaxProjectiles, params.pointsPerLevel, params.gravityStrength);
+        printf("  score   mean %7.1f  p10 %5d  p50 %5d  p90 %5d  max %5d\n", scoreSum / results.size(),
+            percentile(scores, 0.1), percentile(scores, 0.5), percentile(scores, 0.9), scores.back());
+        printf("  length  mean %7.1f s  p10 %6.1f s  p50 %6.1f s  p90 %6.1f s  max %6.1f s\n",
+            totalTicks * tickSeconds / results.size(), percentile(lengths, 0.1) * tickSeconds,
+            percentile(lengths, 0.5) * tickSeconds, percentile(lengths, 0.9) * tickSeconds, lengths.back() * tickSeconds);
+
+        printf("  alive  ");
+        for (double seconds : survivalSeconds) {
+            const uint64_t tick = static_cast<uint64_t>(seconds * Simulation::ticksPerSecond);
+            const size_t alive = lengths.end() - std::upper_bound(lengths.begin(), lengths.end(), tick);
+            printf(" %4.0fs %5.1f%%", seconds, 100.0 * alive / results.size());
+        }
+        printf("\n  %zu games in %.2f s, %.0f ticks/s\n\n", results.size(), wallSeconds, totalTicks / wallSeconds);
+    }
+}
+
+int main(int argc, char* args[])
+{
+    RunOptions options;
+    std::vector<float> waveSizes = { 3 }, healths = { 2 }, ramps = { 5 };
+    std::vector<float> projectiles = { 2 }, levelPoints = { 10 }, gravities = { 6.0f };
+
+    for (int i = 1; i < argc; ++i) {
+        const char* option = args[i];
+        const char* value = i + 1 < argc ? args[i + 1] : nullptr;
+        if (!value) {
+            fprintf(stderr, "%s needs a value\n", option);
+            return 1;
+        }
+        ++i;
+
+        if (strcmp(option, "--games") == 0) options.games = atoi(value);
+        else if (strcmp(option, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(option, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(option, "--jitter") == 0) options.jitter = atoi(value);
+        else if (strcmp(option, "--max-seconds") == 0) options.maxSeconds = atof(value);
+        else if (strcmp(option, "--wave-size") == 0) waveSizes = parseList(value);
+        else if (strcmp(option, "--health") == 0) healths = parseList(value);
+        else if (strcmp(option, "--ramp") == 0) ramps = parseList(value);
+        else if (strcmp(option, "--projectiles") == 0) projectiles = parseList(value);
+        else if (strcmp(option, "--level-points") == 0) levelPoints = parseList(value);
+        else if (strcmp(option, "--gravity") == 0) gravities = parseList(value);
+        else if (strcmp(option, "--trace") == 0) options.tracePath = value;
+        else {
+            fprintf(stderr, "unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    if (options.threads <= 0) {
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (options.games <= 0) {
+        fprintf(stderr, "--games must be positive\n");
+        return 1;
+    }
+    printf("%d games per setting on %d threads, seed %llu\n\n", options.games, options.threads,
+        static_cast<unsigned long long>(options.seed));
+
+    using Clock = std::chrono::steady_clock;
+    std::vector<GameResult> results(options.games);
+
+    for (float waveSize : waveSizes)
+    for (float health : healths)
+    for (float ramp : ramps)
+    for (float projectile : projectiles)
+    for (float points : levelPoints)
+    for (float gravity : gravities) {
+        GameParams params;
+        params.firstWaveSize = static_cast<int>(waveSize);
+        params.firstEntityHealth = static_cast<int>(health);
+        params.wavesPerRamp = std::max(1, static_cast<int>(ramp));
+        params.firstMaxProjectiles = static_cast<int>(projectile);
+        params.pointsPerLevel = static_cast<int>(points);
+        params.gravityStrength = gravity;
+
+        Clock::time_point start = Clock::now();
+
+        //contiguous slices, one per thread
+        std::vector<std::thread> workers;
+        for (int t = 0; t < options.threads; ++t) {
+            const int first = static_cast<int>(static_cast<long long>(options.games) * t / options.threads);
+            const int last = static_cast<int>(static_cast<long long>(options.games) * (t + 1) / options.threads);
+            workers.emplace_back(playWorker, std::cref(params), std::cref(options), first, last, results.data());
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        report(params, results, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+
+    if (options.tracePath && Profiler::isEnabled()) {
+        if (!Profiler::writeChromeTrace(options.tracePath)) {
+            return 1;
+        }
+        printf("trace written to %s, %llu zones dropped\n", options.tracePath,
+            static_cast<unsigned long long>(Profiler::getDroppedCount()));
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "Audio.h"
+#include "SpriteAtlas.h"
+
+/*
+* bakes the game's assets into one archive the game maps at start, see AssetArchive
+*
+* usage: ballpack [--out FILE] [--size WxH] [--raw] FILE...
+* images (.png .jpg .bmp) are decoded and stored as RGBA32, at --size when one was given before them,
+*   the size the game packs them into the atlas at, --size 0x0 goes back to their own size
+* sound effects (.wav .ogg) are decoded to the format Audio opens the mixer with
+* anything else, and the file after --raw, is stored as it is: fonts, and the music the game streams
+* --out is assets.pak by default
+*
+* the game's own assets, run from BALLV3:
+*   ballpack --size 64x64 player.png --size 0x0 bullet2.png wall.png planet1.png planet2.png planet3.png
+*            planet4.png planet5.png background2.png crosshair.png hitSound.wav deathSound.wav
+*            levelUpSound.wav gameOver.wav --raw backgroundMs.wav HomeVideoBold-R90Dv.ttf HomeVideo-BLG6G.ttf
+*/
+
+namespace
+{
+    bool hasExtension(const std::string& path, const char* const* extensions)
+    {
+        const size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos) {
+            return false;
+        }
+        std::string extension = path.substr(dot + 1);
+        for (char& c : extension) {
+            c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+        for (const char* const* candidate = extensions; *candidate; ++candidate) {
+            if (extension == *candidate) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* const imageExtensions[] = { "png", "jpg", "jpeg", "bmp", nullptr };
+    const char* const soundExtensions[] = { "wav", "ogg", nullptr };
+
+    bool nameEntry(ArchiveEntry& entry, const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        const std::string name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+        if (name.size() >= sizeof(entry.name)) {
+            printf("%s: the name is longer than %zu characters\n", path.c_str(), sizeof(entry.name) - 1);
+            return false;
+        }
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, name.c_str(), name.size());
+        return true;
+    }
+
+    bool packImage(const std::string& path, int width, int height, ArchiveEntry& entry, std::vector<uint8_t>& data)
+    {
+        SDL_Surface* loaded = IMG_Load(path.c_str());
+        SDL_Surface* image = loaded ? SpriteAtlas::prepare(loaded, width, height) : nullptr;
+        if (!image) {
+            printf("%s: %s\n", path.c_str(), loaded ? SDL_GetError() : IMG_GetError());
+            return false;
+        }
+
+        entry.kind = ARCHIVE_IMAGE;
+        entry.width = static_cast<uint32_t>(image->w);
+        entry.height = static_cast<uint32_t>(image->h);
+        //rows without the surface's padding
+        data.resize(static_cast<size_t>(image->w) * image->h * 4);
+        SDL_LockSurface(image);
+        for (int y = 0; y < image->h; ++y) {
+            const uint8_t* row = static_cast<const uint8_t*>(image->pixels) + static_cast<size_t>(y) * image->pitch;
+            std::copy(row, row + image->w * 4, data.begin() + static_cast<size_t>(y) * image->w * 4);
+        }
+        SDL_UnlockSurface(image);
+        SDL_FreeSurface(image);
+        return true;
+    }
+
+    bool packSound(const std::string& path, ArchiveEntry& entry, std::vector<uint8_t>& data)
+    {
+        Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+        if (!chunk) {
+            printf("%s: %s\n", path.c_str(), Mix_GetError());
+            return false;
+        }
+        entry.kind = ARCHIVE_SOUND;
+        entry.frequency = Audio::frequency;
+        entry.format = Audio::format;
+        entry.channels = Audio::channels;
+        data.assign(chunk->abuf, chunk->abuf + chunk->alen);
+        Mix_FreeChunk(chunk);
+        return true;
+    }
+
+    bool packRaw(const std::string& path, ArchiveEntry& entry, std::vector<uint8_t>& data)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            printf("%s: could not open\n", path.c_str());
+            return false;
+        }
+        entry.kind = ARCHIVE_RAW;
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string outPath = "assets.pak";
+    std::vector<ArchiveEntry> entries;
+    std::vector<std::vector<uint8_t>> data;
+
+    //no sound card needed, the dummy driver opens exactly the format asked for
+    SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+    if (SDL_Init(SDL_INIT_AUDIO) != 0 || !(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) & IMG_INIT_PNG)
+        || Mix_OpenAudio(Audio::frequency, Audio::format, Audio::channels, Audio::chunkSize) < 0) {
+        printf("SDL initialization failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    int frequency = 0, channels = 0;
+    Uint16 format = 0;
+    Mix_QuerySpec(&frequency, &format, &channels);
+    if (frequency != Audio::frequency || format != Audio::format || channels != Audio::channels) {
+        printf("the mixer opened as %d Hz, format %x, %d channels, not what the game asks for\n", frequency, format, channels);
+        return 1;
+    }
+
+    int width = 0, height = 0;
+    bool raw = false;
+    bool failed = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (strcmp(option, "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+            continue;
+        }
+        if (strcmp(option, "--size") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width < 0 || height < 0) {
+                printf("--size takes WxH, like 64x64\n");
+                return 2;
+            }
+            continue;
+        }
+        if (strcmp(option, "--raw") == 0) {
+            raw = true;
+            continue;
+        }
+
+        ArchiveEntry entry;
+        std::vector<uint8_t> bytes;
+        const std::string path = option;
+        bool packed = nameEntry(entry, path);
+        if (packed && !raw && hasExtension(path, imageExtensions)) {
+            packed = packImage(path, width, height, entry, bytes);
+        }
+        else if (packed && !raw && hasExtension(path, soundExtensions)) {
+            packed = packSound(path, entry, bytes);
+        }
+        else if (packed) {
+            packed = packRaw(path, entry, bytes);
+        }
+        raw = false;
+
+        if (!packed) {
+            failed = true;
+            continue;
+        }
+        printf("%-24s %-5s %9zu bytes\n", entry.name,
+            entry.kind == ARCHIVE_IMAGE ? "image" : entry.kind == ARCHIVE_SOUND ? "sound" : "raw", bytes.size());
+        entries.push_back(entry);
+        data.push_back(std::move(bytes));
+    }
+
+    Mix_CloseAudio();
+    IMG_Quit();
+    SDL_Quit();
+
+    if (entries.empty()) {
+        printf("usage: ballpack [--out FILE] [--size WxH] [--raw] FILE...\n");
+        return 2;
+    }
+    if (failed || !AssetArchive::save(outPath, entries, data)) {
+        return 1;
+    }
+    printf("%zu assets written to %s\n", entries.size(), outPath.c_str());
+    return 0;
+}